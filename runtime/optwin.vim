@@ -460,6 +460,8 @@ call append("$", " \tset ls=" . &ls)
 if has("statusline")
   call append("$", "statusline\talternate format to be used for a status line")
   call <SID>OptionG("stl", &stl)
+  call append("$", "statuslinecache\tremember the result of 'statusline', 'rulerformat' and 'tabline'")
+  call <SID>BinOptionG("slc", &slc)
 endif
 call append("$", "equalalways\tmake all windows the same size when adding/removing windows")
 call <SID>BinOptionG("ea", &ea)
@@ -1078,6 +1080,8 @@ call append("$", "maxmem\tmaximum amount of memory in Kbyte used for one buffer"
 call append("$", " \tset mm=" . &mm)
 call append("$", "maxmemtot\tmaximum amount of memory in Kbyte used for all buffers")
 call append("$", " \tset mmt=" . &mmt)
+call append("$", "compresshidden\tcompress text of hidden buffers kept in memory")
+call <SID>BinOptionG("chi", &chi)
 
 
 call <SID>Header("command line editing")
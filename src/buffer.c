@@ -3900,6 +3900,10 @@ build_stl_str_hl(
 #ifdef FEAT_EVAL
     win_T	*save_curwin;
     buf_T	*save_curbuf;
+    char_u	*expr;
+    char_u	*f;
+    int		hint_flags;
+    int		hint_idx = -1;
 #endif
     int		empty_line;
     colnr_T	virtcol;
@@ -4281,23 +4285,54 @@ build_stl_str_hl(
 	    p = t;
 
 #ifdef FEAT_EVAL
-	    vim_snprintf((char *)buf_tmp, sizeof(buf_tmp),
+	    // "%{=flags:expr}": the result may be reused while what "flags"
+	    // specifies doesn't change.
+	    expr = p;
+	    hint_flags = 0;
+	    if (*expr == '=')
+	    {
+		for (f = expr + 1; vim_strchr((char_u *)"bfcmw", *f) != NULL
+							     && *f != NUL; ++f)
+		    hint_flags |= *f == 'b' ? STL_HINT_BUF
+				: *f == 'f' ? STL_HINT_FILE
+				: *f == 'c' ? STL_HINT_CURSOR
+				: *f == 'm' ? STL_HINT_MODE : STL_HINT_WIN;
+		if (*f == ':')
+		{
+		    hint_flags |= STL_HINT_ON;
+		    expr = f + 1;
+		}
+		else
+		    hint_flags = 0;
+	    }
+
+	    str = NULL;
+	    if (hint_flags != 0)
+		str = stl_cache_item_get(wp, expr, hint_flags, &hint_idx);
+	    if (str == NULL)
+	    {
+		vim_snprintf((char *)buf_tmp, sizeof(buf_tmp),
 							 "%d", curbuf->b_fnum);
-	    set_internal_string_var((char_u *)"g:actual_curbuf", buf_tmp);
-	    vim_snprintf((char *)win_tmp, sizeof(win_tmp), "%d", curwin->w_id);
-	    set_internal_string_var((char_u *)"g:actual_curwin", win_tmp);
+		set_internal_string_var((char_u *)"g:actual_curbuf", buf_tmp);
+		vim_snprintf((char *)win_tmp, sizeof(win_tmp),
+							     "%d", curwin->w_id);
+		set_internal_string_var((char_u *)"g:actual_curwin", win_tmp);
 
-	    save_curbuf = curbuf;
-	    save_curwin = curwin;
-	    curwin = wp;
-	    curbuf = wp->w_buffer;
+		save_curbuf = curbuf;
+		save_curwin = curwin;
+		curwin = wp;
+		curbuf = wp->w_buffer;
 
-	    str = eval_to_string_safe(p, &t, use_sandbox);
+		str = eval_to_string_safe(expr, &t, use_sandbox);
 
-	    curwin = save_curwin;
-	    curbuf = save_curbuf;
-	    do_unlet((char_u *)"g:actual_curbuf", TRUE);
-	    do_unlet((char_u *)"g:actual_curwin", TRUE);
+		curwin = save_curwin;
+		curbuf = save_curbuf;
+		do_unlet((char_u *)"g:actual_curbuf", TRUE);
+		do_unlet((char_u *)"g:actual_curwin", TRUE);
+
+		if (hint_flags != 0)
+		    stl_cache_item_set(hint_idx, str);
+	    }
 
 	    if (str != NULL && *str != 0)
 	    {
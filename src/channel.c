@@ -1703,6 +1703,50 @@ channel_first_nl(readq_T *node)
     return NULL;
 }
 
+/*
+ * Get a message from readahead buffer "node", the first one of
+ * "channel"/"part", up to "nl", or all of it when "nl" is NULL.  The NL is
+ * dropped and removed from the buffer.  NUL bytes are converted to NL, the
+ * internal representation.
+ * The caller must free the result.  Returns NULL when out of memory.
+ */
+    static char_u *
+channel_get_nl_msg(
+	channel_T   *channel,
+	ch_part_T   part,
+	readq_T	    *node,
+	char_u	    *nl)
+{
+    char_u  *buf = node->rq_buffer;
+    char_u  *p;
+    char_u  *msg;
+
+    // Convert NUL to NL, the internal representation.
+    for (p = buf; (nl == NULL || p < nl) && p < buf + node->rq_buflen; ++p)
+	if (*p == NUL)
+	    *p = NL;
+
+    if (nl == NULL)
+    {
+	// get the whole buffer, drop the NL
+	msg = channel_get(channel, part, NULL);
+    }
+    else if (nl + 1 == buf + node->rq_buflen)
+    {
+	// get the whole buffer
+	msg = channel_get(channel, part, NULL);
+	*nl = NUL;
+    }
+    else
+    {
+	// Copy the message into allocated memory (excluding the NL) and
+	// remove it from the buffer (including the NL).
+	msg = vim_strnsave(buf, (int)(nl - buf));
+	channel_consume(channel, part, (int)(nl - buf) + 1);
+    }
+    return msg;
+}
+
 /*
  * Return the first buffer from channel "channel"/"part" and remove it.
  * The caller must free it.
@@ -2498,8 +2542,16 @@ invoke_one_time_callback(
     vim_free(item);
 }
 
+/*
+ * Append the "count" lines in "msgs" to "buffer".
+ */
     static void
-append_to_buffer(buf_T *buffer, char_u *msg, channel_T *channel, ch_part_T part)
+append_to_buffer(
+	buf_T	    *buffer,
+	char_u	    **msgs,
+	int	    count,
+	channel_T   *channel,
+	ch_part_T   part)
 {
     bufref_T	save_curbuf = {NULL, 0, 0};
     win_T	*save_curwin = NULL;
@@ -2520,6 +2572,15 @@ append_to_buffer(buf_T *buffer, char_u *msg, channel_T *channel, ch_part_T part)
 	return;
     }
 
+    /* The first (dummy) line of an empty buffer is replaced, do that
+     * separately. */
+    if (empty && count > 1)
+    {
+	append_to_buffer(buffer, msgs, 1, channel, part);
+	append_to_buffer(buffer, msgs + 1, count - 1, channel, part);
+	return;
+    }
+
     /* If the buffer is also used as input insert above the last
      * line. Don't write these lines. */
     if (save_write_to)
@@ -2529,7 +2590,11 @@ append_to_buffer(buf_T *buffer, char_u *msg, channel_T *channel, ch_part_T part)
     }
 
     /* Append to the buffer */
-    ch_log(channel, "appending line %d to buffer", (int)lnum + 1 - empty);
+    if (count == 1)
+	ch_log(channel, "appending line %d to buffer", (int)lnum + 1 - empty);
+    else
+	ch_log(channel, "appending lines %d to %d to buffer",
+					  (int)lnum + 1, (int)lnum + count);
 
     buffer->b_p_ma = TRUE;
 
@@ -2543,12 +2608,12 @@ append_to_buffer(buf_T *buffer, char_u *msg, channel_T *channel, ch_part_T part)
     if (empty)
     {
 	/* The buffer is empty, replace the first (dummy) line. */
-	ml_replace(lnum, msg, TRUE);
+	ml_replace(lnum, msgs[0], TRUE);
 	lnum = 0;
     }
     else
-	ml_append(lnum, msg, 0, FALSE);
-    appended_lines_mark(lnum, 1L);
+	ml_append_lines(curbuf, lnum, msgs, (long)count, FALSE);
+    appended_lines_mark(lnum, (long)count);
 
     /* Restore curbuf/curwin/curtab */
     restore_win_for_buf(save_curwin, save_curtab, &save_curbuf);
@@ -2571,12 +2636,12 @@ append_to_buffer(buf_T *buffer, char_u *msg, channel_T *channel, ch_part_T part)
 			    : (wp->w_cursor.lnum == lnum
 				&& wp->w_cursor.col == 0);
 
-		// If the cursor is at or above the new line, move it one line
-		// down.  If the topline is outdated update it now.
+		// If the cursor is at or above the new lines, move it down.
+		// If the topline is outdated update it now.
 		if (move_cursor || wp->w_topline > buffer->b_ml.ml_line_count)
 		{
 		    if (move_cursor)
-			++wp->w_cursor.lnum;
+			wp->w_cursor.lnum += count;
 		    save_curwin = curwin;
 		    curwin = wp;
 		    curbuf = curwin->w_buffer;
@@ -2607,6 +2672,46 @@ append_to_buffer(buf_T *buffer, char_u *msg, channel_T *channel, ch_part_T part)
     }
 }
 
+/*
+ * Append "msg" and the complete lines that follow it in the readahead of
+ * "channel"/"part" to "buffer".  For a NL channel without a callback, where
+ * appending lines one by one is slow when a job produces a lot of output.
+ * "msg" is not freed.
+ */
+    static void
+append_nl_msgs_to_buffer(
+	buf_T	    *buffer,
+	char_u	    *msg,
+	channel_T   *channel,
+	ch_part_T   part)
+{
+    garray_T	ga;
+    readq_T	*node;
+    char_u	*nl;
+    char_u	*line;
+    int		i;
+
+    ga_init2(&ga, (int)sizeof(char_u *), 100);
+    if (ga_grow(&ga, 1) == FAIL)
+    {
+	append_to_buffer(buffer, &msg, 1, channel, part);
+	return;
+    }
+    ((char_u **)ga.ga_data)[ga.ga_len++] = msg;
+
+    while (ga_grow(&ga, 1) == OK
+	    && (node = channel_peek(channel, part)) != NULL
+	    && (nl = channel_first_nl(node)) != NULL
+	    && (line = channel_get_nl_msg(channel, part, node, nl)) != NULL)
+	((char_u **)ga.ga_data)[ga.ga_len++] = line;
+
+    append_to_buffer(buffer, (char_u **)ga.ga_data, ga.ga_len, channel, part);
+
+    for (i = 1; i < ga.ga_len; ++i)
+	vim_free(((char_u **)ga.ga_data)[i]);
+    ga_clear(&ga);
+}
+
     static void
 drop_messages(channel_T *channel, ch_part_T part)
 {
@@ -2637,7 +2742,6 @@ may_invoke_callback(channel_T *channel, ch_part_T part)
     cbq_T	*cbitem;
     callback_T	*callback = NULL;
     buf_T	*buffer = NULL;
-    char_u	*p;
 
     if (channel->ch_nb_close_cb != NULL)
 	/* this channel is handled elsewhere (netbeans) */
@@ -2722,7 +2826,6 @@ may_invoke_callback(channel_T *channel, ch_part_T part)
 	if (ch_mode == MODE_NL)
 	{
 	    char_u  *nl = NULL;
-	    char_u  *buf;
 	    readq_T *node;
 
 	    /* See if we have a message ending in NL in the first buffer.  If
@@ -2740,32 +2843,7 @@ may_invoke_callback(channel_T *channel, ch_part_T part)
 		    return FALSE; /* incomplete message */
 		}
 	    }
-	    buf = node->rq_buffer;
-
-	    // Convert NUL to NL, the internal representation.
-	    for (p = buf; (nl == NULL || p < nl)
-					    && p < buf + node->rq_buflen; ++p)
-		if (*p == NUL)
-		    *p = NL;
-
-	    if (nl == NULL)
-	    {
-		// get the whole buffer, drop the NL
-		msg = channel_get(channel, part, NULL);
-	    }
-	    else if (nl + 1 == buf + node->rq_buflen)
-	    {
-		// get the whole buffer
-		msg = channel_get(channel, part, NULL);
-		*nl = NUL;
-	    }
-	    else
-	    {
-		/* Copy the message into allocated memory (excluding the NL)
-		 * and remove it from the buffer (including the NL). */
-		msg = vim_strnsave(buf, (int)(nl - buf));
-		channel_consume(channel, part, (int)(nl - buf) + 1);
-	    }
+	    msg = channel_get_nl_msg(channel, part, node, nl);
 	}
 	else
 	{
@@ -2821,7 +2899,10 @@ may_invoke_callback(channel_T *channel, ch_part_T part)
 		    write_to_term(buffer, msg, channel);
 		else
 #endif
-		    append_to_buffer(buffer, msg, channel, part);
+		if (ch_mode == MODE_NL && callback == NULL)
+		    append_nl_msgs_to_buffer(buffer, msg, channel, part);
+		else
+		    append_to_buffer(buffer, &msg, 1, channel, part);
 	    }
 	}
 
@@ -127,6 +127,25 @@ find_win_for_curbuf(void)
     }
 }
 
+/*
+ * Append the lines collected in "gap" after line "lnum" in curbuf.
+ * Empties "gap".  Returns FAIL when not all lines could be appended.
+ */
+    static int
+append_pending_lines(garray_T *gap, linenr_T lnum)
+{
+    long    count = gap->ga_len;
+
+    gap->ga_len = 0;
+    // When starting up, we might still need to create the memfile
+    if (curbuf->b_ml.ml_mfp == NULL && open_buffer(FALSE, NULL, 0) == FAIL)
+	return FAIL;
+    if (ml_append_lines(curbuf, lnum, (char_u **)gap->ga_data, count, FALSE)
+								     < count)
+	return FAIL;
+    return OK;
+}
+
 /*
  * Set line or list of lines in buffer "buf".
  */
@@ -140,10 +159,13 @@ set_buffer_lines(
 {
     linenr_T    lnum = lnum_arg + (append ? 1 : 0);
     char_u	*line = NULL;
+    int		line_is_string = FALSE;
     list_T	*l = NULL;
     listitem_T	*li = NULL;
     long	added = 0;
     linenr_T	append_lnum;
+    garray_T	pending;	// lines to be appended after "pending_lnum"
+    linenr_T	pending_lnum = 0;
     buf_T	*curbuf_save = NULL;
     win_T	*curwin_save = NULL;
     int		is_curbuf = buf == curbuf;
@@ -180,6 +202,7 @@ set_buffer_lines(
     }
     else
 	line = tv_get_string_chk(lines);
+    ga_init2(&pending, (int)sizeof(char_u *), 50);
 
     // default result is zero == OK
     for (;;)
@@ -190,11 +213,13 @@ set_buffer_lines(
 	    if (li == NULL)
 		break;
 	    line = tv_get_string_chk(&li->li_tv);
+	    line_is_string = li->li_tv.v_type == VAR_STRING;
 	    li = li->li_next;
 	}
 
 	rettv->vval.v_number = 1;	// FAIL
-	if (line == NULL || lnum > curbuf->b_ml.ml_line_count + 1)
+	if (line == NULL
+		|| lnum > curbuf->b_ml.ml_line_count + pending.ga_len + 1)
 	    break;
 
 	// When coming here from Insert mode, sync undo, so that this can be
@@ -222,14 +247,33 @@ set_buffer_lines(
 	{
 	    // append the line
 	    ++added;
-	    if (ml_append(lnum - 1, line, (colnr_T)0, FALSE) == OK)
+	    if (l != NULL && line_is_string && ga_grow(&pending, 1) == OK)
+	    {
+		// The text of a String item stays valid, append it together
+		// with the following lines.
+		if (pending.ga_len == 0)
+		    pending_lnum = lnum - 1;
+		((char_u **)pending.ga_data)[pending.ga_len++] = line;
 		rettv->vval.v_number = 0;	// OK
+	    }
+	    else
+	    {
+		if (pending.ga_len > 0
+			&& append_pending_lines(&pending, pending_lnum) == FAIL)
+		    break;
+		if (ml_append(lnum - 1, line, (colnr_T)0, FALSE) == OK)
+		    rettv->vval.v_number = 0;	// OK
+	    }
 	}
 
 	if (l == NULL)			// only one string argument
 	    break;
 	++lnum;
     }
+    if (pending.ga_len > 0
+			&& append_pending_lines(&pending, pending_lnum) == FAIL)
+	rettv->vval.v_number = 1;	// FAIL
+    ga_clear(&pending);
 
     if (added > 0)
     {
@@ -567,6 +567,7 @@ static funcentry_T global_functions[] =
     {"matchstr",	2, 4, FEARG_1,	  f_matchstr},
     {"matchstrpos",	2, 4, FEARG_1,	  f_matchstrpos},
     {"max",		1, 1, FEARG_1,	  f_max},
+    {"memfile_stats",	0, 1, FEARG_1,	  f_memfile_stats},
     {"min",		1, 1, FEARG_1,	  f_min},
     {"mkdir",		1, 3, FEARG_1,	  f_mkdir},
     {"mode",		0, 1, FEARG_1,	  f_mode},
@@ -614,6 +615,7 @@ static funcentry_T global_functions[] =
 #endif
 #ifdef FEAT_TEXT_PROP
     {"prop_add",	3, 3, FEARG_1,	  f_prop_add},
+    {"prop_add_list",	2, 2, FEARG_1,	  f_prop_add_list},
     {"prop_clear",	1, 3, FEARG_1,	  f_prop_clear},
     {"prop_list",	1, 2, FEARG_1,	  f_prop_list},
     {"prop_remove",	1, 3, FEARG_1,	  f_prop_remove},
@@ -637,8 +639,10 @@ static funcentry_T global_functions[] =
     {"range",		1, 3, FEARG_1,	  f_range},
     {"readdir",		1, 2, FEARG_1,	  f_readdir},
     {"readfile",	1, 3, FEARG_1,	  f_readfile},
+    {"redraw_stats",	0, 1, 0,	  f_redraw_stats},
     {"reg_executing",	0, 0, 0,	  f_reg_executing},
     {"reg_recording",	0, 0, 0,	  f_reg_recording},
+    {"regexp_stats",	0, 0, 0,	  f_regexp_stats},
     {"reltime",		0, 2, FEARG_1,	  f_reltime},
 #ifdef FEAT_FLOAT
     {"reltimefloat",	1, 1, FEARG_1,	  f_reltimefloat},
@@ -752,6 +756,9 @@ static funcentry_T global_functions[] =
     {"synIDtrans",	1, 1, FEARG_1,	  f_synIDtrans},
     {"synconcealed",	2, 2, 0,	  f_synconcealed},
     {"synstack",	2, 2, 0,	  f_synstack},
+#if defined(FEAT_SYN_HL) && defined(FEAT_PROFILE)
+    {"syntime_info",	0, 0, 0,	  f_syntime_info},
+#endif
     {"system",		1, 2, FEARG_1,	  f_system},
     {"systemlist",	1, 2, FEARG_1,	  f_systemlist},
     {"tabpagebuflist",	0, 1, FEARG_1,	  f_tabpagebuflist},
@@ -821,6 +828,7 @@ static funcentry_T global_functions[] =
     {"test_setmouse",	2, 2, 0,	  f_test_setmouse},
 #endif
     {"test_settime",	1, 1, FEARG_1,	  f_test_settime},
+    {"test_syntax_idle_parse", 1, 1, FEARG_1, f_test_syntax_idle_parse},
 #ifdef FEAT_TIMERS
     {"timer_info",	0, 1, FEARG_1,	  f_timer_info},
     {"timer_pause",	2, 2, FEARG_1,	  f_timer_pause},
@@ -7308,6 +7308,9 @@ ex_redrawtabline(exarg_T *eap UNUSED)
     RedrawingDisabled = 0;
     p_lz = FALSE;
 
+#ifdef FEAT_STL_OPT
+    ++stl_cache_tick;
+#endif
     draw_tabline();
 
     RedrawingDisabled = r;
@@ -1509,7 +1509,8 @@ before_blocking(void)
  * or when we have waited some time for a character (c == 0)
  *
  * All the changed memfiles are synced if c == 0 or when the number of typed
- * characters reaches 'updatecount' and 'updatecount' is non-zero.
+ * characters reaches 'updatecount' and 'updatecount' is non-zero.  Then the
+ * memfiles of hidden buffers are also compressed if 'compresshidden' is set.
  */
     static void
 updatescript(int c)
@@ -1521,6 +1522,7 @@ updatescript(int c)
     if (c == 0 || (p_uc > 0 && ++count >= p_uc))
     {
 	ml_sync_all(c == 0, TRUE);
+	ml_compress_hidden();
 	count = 0;
     }
 }
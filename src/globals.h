@@ -252,6 +252,7 @@ EXTERN int	debug_tick INIT(= 0);		// breakpoint change count
 EXTERN int	debug_backtrace_level INIT(= 0); // breakpoint backtrace level
 # ifdef FEAT_PROFILE
 EXTERN int	do_profiling INIT(= PROF_NONE);	// PROF_ values
+EXTERN int	redraw_time_on INIT(= FALSE);	// timing redraw phases
 # endif
 EXTERN garray_T script_items INIT(= {0 COMMA 0 COMMA sizeof(scriptitem_T) COMMA 4 COMMA NULL});
 #define SCRIPT_ITEM(id) (((scriptitem_T *)script_items.ga_data)[(id) - 1])
@@ -370,6 +371,10 @@ EXTERN int include_link INIT(= 0);	// when 2 include "link" and "clear"
 EXTERN int	highlight_match INIT(= FALSE);	// show search match pos
 EXTERN linenr_T	search_match_lines;		// lines of of matched string
 EXTERN colnr_T	search_match_endcol;		// col nr of match end
+
+// Incremented when 'iskeyword', 'isident', 'isfname' or 'isprint' is
+// applied, used to find out if the matches of a pattern may have changed.
+EXTERN int	chartab_tick INIT(= 0);
 #ifdef FEAT_SEARCH_EXTRA
 EXTERN linenr_T	search_first_line INIT(= 0);	  // for :{FIRST},{last}s/pat
 EXTERN linenr_T	search_last_line INIT(= MAXLNUM); // for :{first},{LAST}s/pat
@@ -671,6 +676,8 @@ EXTERN int	arg_had_last INIT(= FALSE); // accessed last file in
 EXTERN int	ru_col;		// column for ruler
 #ifdef FEAT_STL_OPT
 EXTERN int	ru_wid;		// 'rulerfmt' width of ruler when non-zero
+EXTERN int	stl_cache_tick INIT(= 0); // incremented to invalidate cached
+					  // status lines
 #endif
 EXTERN int	sc_col;		// column for shown command
 
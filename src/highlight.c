@@ -3653,6 +3653,307 @@ free_highlight_fonts(void)
 
 # define SEARCH_HL_PRIORITY 0
 
+/*
+ * With many matches in a window, e.g. added by a linter, trying each pattern
+ * on every line is slow.  Most patterns start with some literal text that
+ * every match must contain.  These texts are put in an Aho-Corasick
+ * automaton, one pass over a line then finds out which of them are in the
+ * line.  The patterns whose text is not in the line are not tried there.
+ */
+typedef struct
+{
+    int		mn_child;	// first child node, zero if none
+    int		mn_sibling;	// next child of the same parent, zero if none
+    int		mn_fail;	// node for the longest proper suffix
+    int		mn_dict;	// next node on the fail chain that ends a
+				// literal, zero if none
+    int		mn_lit;		// literal ending in this node or -1
+    char_u	mn_byte;	// byte leading to this node
+} matchlit_node_T;
+
+struct matchlit_S
+{
+    matchlit_node_T *ml_node;	    // trie nodes, ml_node[0] is the root
+    int		    ml_node_count;
+    int		    ml_node_alloc;
+    int		    ml_root[256];   // children of the root, zero if none
+    int		    ml_lit_count;   // number of different literals
+    long	    *ml_seen;	    // for each literal: ml_scan_nr when it
+				    // was found in the line
+    long	    ml_scan_nr;	    // incremented for each line
+};
+
+// Only worth it when there are a few matches with a literal.
+#define MATCHLIT_MIN	2
+
+/*
+ * Find the literal text that any match of "pat", used with 'magic', must
+ * contain.  Sets "*start" to where it starts and returns its length.
+ * Returns zero when there is no such text.
+ */
+    static int
+match_literal(char_u *pat, char_u **start)
+{
+    char_u	*p;
+    char_u	*last = NULL;	// start of the last character
+
+    // Give up on items that change the meaning of the rest of the pattern
+    // or can make the text optional.
+    if (pat == NULL
+	    || strstr((char *)pat, "\\|") != NULL
+	    || strstr((char *)pat, "\\&") != NULL
+	    || strstr((char *)pat, "\\%") != NULL
+	    || strstr((char *)pat, "\\c") != NULL
+	    || strstr((char *)pat, "\\C") != NULL
+	    || strstr((char *)pat, "\\v") != NULL
+	    || strstr((char *)pat, "\\V") != NULL
+	    || strstr((char *)pat, "\\M") != NULL
+	    || strstr((char *)pat, "\\Z") != NULL)
+	return 0;
+
+    // A start-of-word item does not match text.
+    if (STRNCMP(pat, "\\<", 2) == 0)
+	pat += 2;
+    *start = pat;
+    for (p = pat; *p != NUL && vim_strchr((char_u *)"^$.*[~\\", *p) == NULL;
+							       p += MB_PTR2LEN(p))
+	last = p;
+    // A multi after the text applies to its last character.
+    if (*p == '*' || (*p == '\\' && p[1] != NUL
+			       && vim_strchr((char_u *)"=?+{@", p[1]) != NULL))
+	p = last == NULL ? pat : last;
+    return (int)(p - pat);
+}
+
+/*
+ * Return the child of node "n" for byte "c", zero if there is none.
+ */
+    static int
+matchlit_child(matchlit_T *ml, int n, int c)
+{
+    int		child;
+
+    if (n == 0)
+	return ml->ml_root[c];
+    for (child = ml->ml_node[n].mn_child; child != 0;
+					     child = ml->ml_node[child].mn_sibling)
+	if (ml->ml_node[child].mn_byte == c)
+	    return child;
+    return 0;
+}
+
+/*
+ * Add a new node for byte "c" as a child of node "n".
+ * Returns the new node, zero when out of memory.
+ */
+    static int
+matchlit_add_node(matchlit_T *ml, int n, int c)
+{
+    matchlit_node_T *node;
+    int		    new_node;
+
+    if (ml->ml_node_count == ml->ml_node_alloc)
+    {
+	int		newsize = ml->ml_node_alloc * 2;
+	matchlit_node_T *p = vim_realloc(ml->ml_node,
+					    newsize * sizeof(matchlit_node_T));
+
+	if (p == NULL)
+	    return 0;
+	ml->ml_node = p;
+	ml->ml_node_alloc = newsize;
+    }
+    new_node = ml->ml_node_count++;
+    node = &ml->ml_node[new_node];
+    vim_memset(node, 0, sizeof(matchlit_node_T));
+    node->mn_lit = -1;
+    node->mn_byte = c;
+    if (n == 0)
+	ml->ml_root[c] = new_node;
+    else
+    {
+	node->mn_sibling = ml->ml_node[n].mn_child;
+	ml->ml_node[n].mn_child = new_node;
+    }
+    return new_node;
+}
+
+/*
+ * Add literal "pat" with length "len" to the trie.  Returns the index of the
+ * literal, which is shared with an equal one, or -1 when out of memory.
+ */
+    static int
+matchlit_add(matchlit_T *ml, char_u *pat, int len)
+{
+    int		n = 0;
+    int		child;
+    int		i;
+
+    for (i = 0; i < len; ++i)
+    {
+	child = matchlit_child(ml, n, pat[i]);
+	if (child == 0 && (child = matchlit_add_node(ml, n, pat[i])) == 0)
+	    return -1;
+	n = child;
+    }
+    if (ml->ml_node[n].mn_lit < 0)
+	ml->ml_node[n].mn_lit = ml->ml_lit_count++;
+    return ml->ml_node[n].mn_lit;
+}
+
+/*
+ * Set the fail and dictionary links, going over the trie breadth first.
+ */
+    static int
+matchlit_link(matchlit_T *ml)
+{
+    int		*queue;
+    int		head = 0;
+    int		tail = 0;
+    int		c;
+
+    queue = ALLOC_MULT(int, ml->ml_node_count);
+    if (queue == NULL)
+	return FAIL;
+    for (c = 0; c < 256; ++c)
+	if (ml->ml_root[c] != 0)
+	    queue[tail++] = ml->ml_root[c];
+    while (head < tail)
+    {
+	int	n = queue[head++];
+	int	child;
+
+	for (child = ml->ml_node[n].mn_child; child != 0;
+					     child = ml->ml_node[child].mn_sibling)
+	{
+	    matchlit_node_T *node = &ml->ml_node[child];
+	    int		    f = ml->ml_node[n].mn_fail;
+
+	    while (f != 0 && matchlit_child(ml, f, node->mn_byte) == 0)
+		f = ml->ml_node[f].mn_fail;
+	    node->mn_fail = matchlit_child(ml, f, node->mn_byte);
+	    node->mn_dict = ml->ml_node[node->mn_fail].mn_lit >= 0
+				? node->mn_fail : ml->ml_node[node->mn_fail].mn_dict;
+	    queue[tail++] = child;
+	}
+    }
+    vim_free(queue);
+    return OK;
+}
+
+/*
+ * Free the literal match automaton of window "wp".
+ */
+    static void
+matchlit_clear(win_T *wp)
+{
+    matchitem_T *cur;
+
+    if (wp->w_match_lit != NULL)
+    {
+	vim_free(wp->w_match_lit->ml_node);
+	vim_free(wp->w_match_lit->ml_seen);
+	VIM_CLEAR(wp->w_match_lit);
+    }
+    for (cur = wp->w_match_head; cur != NULL; cur = cur->next)
+	cur->lit_idx = -1;
+    wp->w_match_lit_valid = FALSE;
+}
+
+/*
+ * Return the length of the literal that a match of "cur" must contain, zero
+ * if there is none.  Sets "*start" to where it starts in the pattern.
+ */
+    static int
+matchlit_len(matchitem_T *cur, char_u **start)
+{
+    // A match of a multi-line pattern may start in a previous line.
+    if (cur->match.regprog == NULL || re_multiline(cur->match.regprog))
+	return 0;
+    return match_literal(cur->pattern, start);
+}
+
+/*
+ * Build the literal match automaton for window "wp".  When there are not
+ * enough matches with a literal, or on failure, "wp->w_match_lit" is NULL.
+ */
+    static void
+matchlit_build(win_T *wp)
+{
+    matchlit_T	*ml;
+    matchitem_T *cur;
+    char_u	*start;
+    int		len;
+    int		count = 0;
+
+    matchlit_clear(wp);
+    wp->w_match_lit_valid = TRUE;
+    for (cur = wp->w_match_head; cur != NULL; cur = cur->next)
+	if (matchlit_len(cur, &start) > 0)
+	    ++count;
+    if (count < MATCHLIT_MIN)
+	return;
+
+    ml = ALLOC_CLEAR_ONE(matchlit_T);
+    if (ml == NULL)
+	return;
+    wp->w_match_lit = ml;
+    ml->ml_node_alloc = 64;
+    ml->ml_node = ALLOC_MULT(matchlit_node_T, ml->ml_node_alloc);
+    if (ml->ml_node == NULL)
+    {
+	matchlit_clear(wp);
+	return;
+    }
+    // The root node.
+    vim_memset(ml->ml_node, 0, sizeof(matchlit_node_T));
+    ml->ml_node[0].mn_lit = -1;
+    ml->ml_node_count = 1;
+
+    for (cur = wp->w_match_head; cur != NULL; cur = cur->next)
+	if ((len = matchlit_len(cur, &start)) > 0
+		&& (cur->lit_idx = matchlit_add(ml, start, len)) < 0)
+	{
+	    matchlit_clear(wp);
+	    return;
+	}
+
+    ml->ml_seen = ALLOC_CLEAR_MULT(long, ml->ml_lit_count);
+    if (ml->ml_seen == NULL || matchlit_link(ml) == FAIL)
+	matchlit_clear(wp);
+}
+
+/*
+ * Find out which literals are in "line".
+ */
+    static void
+matchlit_scan(matchlit_T *ml, char_u *line)
+{
+    char_u	*p;
+    int		n = 0;
+    int		found = 0;
+
+    ++ml->ml_scan_nr;
+    for (p = line; *p != NUL && found < ml->ml_lit_count; ++p)
+    {
+	int	next;
+	int	d;
+
+	while ((next = matchlit_child(ml, n, *p)) == 0 && n != 0)
+	    n = ml->ml_node[n].mn_fail;
+	n = next;
+
+	// Mark the literal ending here and the ones that are a suffix of it.
+	for (d = ml->ml_node[n].mn_lit >= 0 ? n : ml->ml_node[n].mn_dict;
+					     d != 0; d = ml->ml_node[d].mn_dict)
+	    if (ml->ml_seen[ml->ml_node[d].mn_lit] != ml->ml_scan_nr)
+	    {
+		ml->ml_seen[ml->ml_node[d].mn_lit] = ml->ml_scan_nr;
+		++found;
+	    }
+    }
+}
+
 /*
  * Add match to the match list of window 'wp'.  The pattern 'pat' will be
  * highlighted with the group 'grp' with priority 'prio'.
@@ -3728,6 +4029,7 @@ match_add(
     m->match.regprog = regprog;
     m->match.rmm_ic = FALSE;
     m->match.rmm_maxcol = 0;
+    m->lit_idx = -1;
 # if defined(FEAT_CONCEAL)
     m->conceal_char = 0;
     if (conceal_char != NULL)
@@ -3845,6 +4147,7 @@ match_add(
     else
 	prev->next = m;
     m->next = cur;
+    wp->w_match_lit_valid = FALSE;
 
     redraw_win_later(wp, rtype);
     return id;
@@ -3887,6 +4190,8 @@ match_delete(win_T *wp, int id, int perr)
 	wp->w_match_head = cur->next;
     else
 	prev->next = cur->next;
+    wp->w_match_lit_valid = FALSE;
+    wp->w_match_active = NULL;
     vim_regfree(cur->match.regprog);
     vim_free(cur->pattern);
     if (cur->pos.toplnum != 0)
@@ -3928,6 +4233,8 @@ clear_matches(win_T *wp)
 	vim_free(wp->w_match_head);
 	wp->w_match_head = m;
     }
+    wp->w_match_active = NULL;
+    matchlit_clear(wp);
     redraw_win_later(wp, SOME_VALID);
 }
 
@@ -3953,6 +4260,9 @@ init_search_hl(win_T *wp, match_T *search_hl)
 {
     matchitem_T *cur;
 
+    if (!wp->w_match_lit_valid)
+	matchlit_build(wp);
+
     // Setup for match and 'hlsearch' highlighting.  Disable any previous
     // match
     cur = wp->w_match_head;
@@ -4277,6 +4587,10 @@ prepare_search_hl_line(
     int		shl_flag;		// flag to indicate whether search_hl
 					// has been processed or not
     int		area_highlighting = FALSE;
+    matchitem_T **active = &wp->w_match_active;
+
+    if (wp->w_match_lit != NULL)
+	matchlit_scan(wp->w_match_lit, *line);
 
     /*
      * Handle highlighting the last used search pattern and matches.
@@ -4300,7 +4614,13 @@ prepare_search_hl_line(
 	shl->is_addpos = FALSE;
 	if (cur != NULL)
 	    cur->pos.cur = 0;
-	next_search_hl(wp, search_hl, shl, lnum, mincol,
+	if (shl != search_hl && cur->lit_idx >= 0 && wp->w_match_lit != NULL
+		&& wp->w_match_lit->ml_seen[cur->lit_idx]
+						  != wp->w_match_lit->ml_scan_nr)
+	    // The literal text of the pattern is not in this line.
+	    shl->lnum = 0;
+	else
+	    next_search_hl(wp, search_hl, shl, lnum, mincol,
 						shl == search_hl ? NULL : cur);
 
 	// Need to get the line again, a multi-line regexp may have made it
@@ -4334,8 +4654,18 @@ prepare_search_hl_line(
 	    area_highlighting = TRUE;
 	}
 	if (shl != search_hl && cur != NULL)
+	{
+	    // Only a match that is in this line needs to be checked for each
+	    // column, the others can't start in this line.
+	    if (shl->startcol != MAXCOL)
+	    {
+		*active = cur;
+		active = &cur->next_active;
+	    }
 	    cur = cur->next;
+	}
     }
+    *active = NULL;
     return area_highlighting;
 }
 
@@ -4369,7 +4699,7 @@ update_search_hl(
 
 
     // Do this for 'search_hl' and the match list (ordered by priority).
-    cur = wp->w_match_head;
+    cur = wp->w_match_active;
     shl_flag = WIN_IS_POPUP(wp);
     while (cur != NULL || shl_flag == FALSE)
     {
@@ -4448,12 +4778,12 @@ update_search_hl(
 	    break;
 	}
 	if (shl != search_hl && cur != NULL)
-	    cur = cur->next;
+	    cur = cur->next_active;
     }
 
     // Use attributes from match with highest priority among 'search_hl' and
     // the match list.
-    cur = wp->w_match_head;
+    cur = wp->w_match_active;
     shl_flag = WIN_IS_POPUP(wp);
     while (cur != NULL || shl_flag == FALSE)
     {
@@ -4470,7 +4800,7 @@ update_search_hl(
 	if (shl->attr_cur != 0)
 	    search_attr = shl->attr_cur;
 	if (shl != search_hl && cur != NULL)
-	    cur = cur->next;
+	    cur = cur->next_active;
     }
     // Only highlight one character after the last column.
     if (*(*line + col) == NUL && (did_line_attr >= 1
@@ -4494,7 +4824,7 @@ get_prevcol_hl_flag(win_T *wp, match_T *search_hl, long curcol)
 	prevcol_hl_flag = TRUE;
     else
     {
-	cur = wp->w_match_head;
+	cur = wp->w_match_active;
 	while (cur != NULL)
 	{
 	    if (!cur->hl.is_addpos && prevcol == (long)cur->hl.startcol)
@@ -4502,7 +4832,7 @@ get_prevcol_hl_flag(win_T *wp, match_T *search_hl, long curcol)
 		prevcol_hl_flag = TRUE;
 		break;
 	    }
-	    cur = cur->next;
+	    cur = cur->next_active;
 	}
     }
     return prevcol_hl_flag;
@@ -4520,7 +4850,7 @@ get_search_match_hl(win_T *wp, match_T *search_hl, long col, int *char_attr)
     int		shl_flag;		// flag to indicate whether search_hl
 					// has been processed or not
 
-    cur = wp->w_match_head;
+    cur = wp->w_match_active;
     shl_flag = WIN_IS_POPUP(wp);
     while (cur != NULL || shl_flag == FALSE)
     {
@@ -4538,7 +4868,7 @@ get_search_match_hl(win_T *wp, match_T *search_hl, long col, int *char_attr)
 		&& (shl == search_hl || !shl->is_addpos))
 	    *char_attr = shl->attr;
 	if (shl != search_hl && cur != NULL)
-	    cur = cur->next;
+	    cur = cur->next_active;
     }
 }
 
@@ -65,7 +65,48 @@ extern int dos2;			/* this is in os_amiga.c */
 # endif
 #endif
 
+#if defined(UNIX) && defined(HAVE_WRITEV) && defined(HAVE_SYS_UIO_H)
+# include <sys/uio.h>			/* for writev() */
+# define USE_MF_WRITEV
+#endif
+
 #define MEMFILE_PAGE_SIZE 4096		/* default page size */
+#define MF_WRITEV_MAX	64		/* max nr of blocks in one writev() */
+
+/*
+ * The used list is managed with a simplified "2Q" policy, so that going over
+ * all the lines of a large buffer once, e.g. with ":g" or ":%s", does not
+ * push out the blocks that are used all the time:
+ * - A block read from the swap file goes into the probation part of the used
+ *   list, after the hot blocks.  It keeps its place when it is used again
+ *   shortly after, the probation part is a FIFO.
+ * - When a probation block is released its number is remembered in the ghost
+ *   list.  When it is needed again while still in the ghost list it is used
+ *   over a longer time and it goes into the hot part.
+ * - The hot part is kept in LRU order.
+ * - Blocks are released from the probation part when it holds more than a
+ *   quarter of the allowed pages, otherwise from the hot part.
+ * New pointer blocks are hot, new data blocks start in probation.
+ */
+#define MF_PROBATION_MAX(mfp)	((mfp)->mf_used_count_max / 4)
+#define MF_GHOST_MAX(mfp)	((mfp)->mf_used_count_max / 2)
+
+/* Number of bytes of memory used for the data of block "hp". */
+#define MF_BLOCK_MEM(mfp, hp)	(((hp)->bh_flags & BH_COMPRESSED) \
+		    ? (long_u)(hp)->bh_comp_len \
+		    : (long_u)(hp)->bh_page_count * (mfp)->mf_page_size)
+
+/*
+ * Blocks of hidden buffers can be compressed in memory, see mf_compress().
+ * The format is a simple LZ77 variant: A byte below 0x80 is followed by that
+ * number plus one of literal bytes.  A byte 0x80 or above is a match of
+ * (byte & 0x7f) + MF_LZ_MINMATCH bytes, followed by two bytes with the
+ * distance back, least significant byte first.
+ */
+#define MF_LZ_MINMATCH	4
+#define MF_LZ_MAXMATCH	(0x7f + MF_LZ_MINMATCH)
+#define MF_LZ_MAXLIT	0x80
+#define MF_LZ_HASHBITS	12
 
 static long_u	total_mem_used = 0;	/* total memory used for memfiles */
 
@@ -74,6 +115,8 @@ static void mf_rem_hash(memfile_T *, bhdr_T *);
 static bhdr_T *mf_find_hash(memfile_T *, blocknr_T);
 static void mf_ins_used(memfile_T *, bhdr_T *);
 static void mf_rem_used(memfile_T *, bhdr_T *);
+static void mf_ghost_add(memfile_T *, blocknr_T);
+static int mf_ghost_del(memfile_T *, blocknr_T);
 static bhdr_T *mf_release(memfile_T *, int);
 static bhdr_T *mf_alloc_bhdr(memfile_T *, int);
 static void mf_free_bhdr(bhdr_T *);
@@ -82,6 +125,10 @@ static bhdr_T *mf_rem_free(memfile_T *);
 static int  mf_read(memfile_T *, bhdr_T *);
 static int  mf_write(memfile_T *, bhdr_T *);
 static int  mf_write_block(memfile_T *mfp, bhdr_T *hp, off_T offset, unsigned size);
+static int  mf_decompress(memfile_T *mfp, bhdr_T *hp);
+#ifdef USE_MF_WRITEV
+static int  mf_sync_coalesced(memfile_T *mfp, int flags);
+#endif
 static int  mf_trans_add(memfile_T *, bhdr_T *);
 static void mf_do_open(memfile_T *, char_u *, int);
 static void mf_hash_init(mf_hashtab_T *);
@@ -154,10 +201,24 @@ mf_open(char_u *fname, int flags)
     mfp->mf_free_first = NULL;		/* free list is empty */
     mfp->mf_used_first = NULL;		/* used list is empty */
     mfp->mf_used_last = NULL;
+    mfp->mf_used_mid = NULL;
     mfp->mf_dirty = FALSE;
     mfp->mf_used_count = 0;
+    mfp->mf_probation_count = 0;
+    mfp->mf_compressed_count = 0;
+    mfp->mf_compress_next = NULL;
+    mfp->mf_compress_done = FALSE;
     mf_hash_init(&mfp->mf_hash);
     mf_hash_init(&mfp->mf_trans);
+    mf_hash_init(&mfp->mf_ghost);
+    mfp->mf_ghost_first = NULL;
+    mfp->mf_ghost_last = NULL;
+    mfp->mf_stat_hits = 0;
+    mfp->mf_stat_misses = 0;
+    mfp->mf_stat_ghost_hits = 0;
+    mfp->mf_stat_evictions = 0;
+    mfp->mf_stat_reads = 0;
+    mfp->mf_stat_writes = 0;
     mfp->mf_page_size = MEMFILE_PAGE_SIZE;
 #ifdef FEAT_CRYPT
     mfp->mf_old_key = NULL;
@@ -252,7 +313,7 @@ mf_close(memfile_T *mfp, int del_file)
 					    /* free entries in used list */
     for (hp = mfp->mf_used_first; hp != NULL; hp = nextp)
     {
-	total_mem_used -= hp->bh_page_count * mfp->mf_page_size;
+	total_mem_used -= MF_BLOCK_MEM(mfp, hp);
 	nextp = hp->bh_next;
 	mf_free_bhdr(hp);
     }
@@ -260,6 +321,7 @@ mf_close(memfile_T *mfp, int del_file)
 	vim_free(mf_rem_free(mfp));
     mf_hash_free(&mfp->mf_hash);
     mf_hash_free_all(&mfp->mf_trans);	    /* free hashtable and its items */
+    mf_hash_free_all(&mfp->mf_ghost);
     vim_free(mfp->mf_fname);
     vim_free(mfp->mf_ffname);
     vim_free(mfp);
@@ -390,6 +452,8 @@ mf_new(memfile_T *mfp, int negative, int page_count)
 	}
     }
     hp->bh_flags = BH_LOCKED | BH_DIRTY;	/* new block is always dirty */
+    if (!negative)
+	hp->bh_flags |= BH_HOT;		/* pointer blocks are used a lot */
     mfp->mf_dirty = TRUE;
     hp->bh_page_count = page_count;
     mf_ins_used(mfp, hp);
@@ -446,15 +510,30 @@ mf_get(memfile_T *mfp, blocknr_T nr, int page_count)
 	    mf_free_bhdr(hp);
 	    return NULL;
 	}
+	++mfp->mf_stat_misses;
+
+	/* Used again after it was released from probation: it is hot. */
+	if (mf_ghost_del(mfp, nr))
+	{
+	    hp->bh_flags |= BH_HOT;
+	    ++mfp->mf_stat_ghost_hits;
+	}
+	mf_ins_used(mfp, hp);
     }
     else
     {
-	mf_rem_used(mfp, hp);	/* remove from list, insert in front below */
+	if ((hp->bh_flags & BH_COMPRESSED) && mf_decompress(mfp, hp) == FAIL)
+	    return NULL;
+	++mfp->mf_stat_hits;
+	if (hp->bh_flags & BH_HOT)
+	{
+	    mf_rem_used(mfp, hp);   /* put in front of used list */
+	    mf_ins_used(mfp, hp);
+	}
 	mf_rem_hash(mfp, hp);
     }
 
     hp->bh_flags |= BH_LOCKED;
-    mf_ins_used(mfp, hp);	/* put in front of used list */
     mf_ins_hash(mfp, hp);	/* put in front of hash list */
 
     return hp;
@@ -484,10 +563,11 @@ mf_put(
     flags &= ~BH_LOCKED;
     if (dirty)
     {
-	flags |= BH_DIRTY;
+	flags = (flags | BH_DIRTY) & ~BH_NOCOMPRESS;
 	mfp->mf_dirty = TRUE;
     }
     hp->bh_flags = flags;
+    mfp->mf_compress_done = FALSE;	// may compress the block now
     if (infile)
 	mf_trans_add(mfp, hp);	    /* may translate negative in positive nr */
 }
@@ -558,6 +638,16 @@ mf_sync(memfile_T *mfp, int flags)
      * fails then we give up.
      */
     status = OK;
+    hp = mfp->mf_used_last;
+#ifdef USE_MF_WRITEV
+    /*
+     * First write the blocks that are already in the file, combining blocks
+     * with adjacent numbers.  The loop below then only needs to handle block
+     * zero and new blocks.  When interrupted "hp" is not NULL, thus the
+     * memfile stays dirty.
+     */
+    if ((flags & MFS_ZERO) || mf_sync_coalesced(mfp, flags) == OK)
+#endif
     for (hp = mfp->mf_used_last; hp != NULL; hp = hp->bh_prev)
 	if (((flags & MFS_ALL) || hp->bh_bnum >= 0)
 		&& (hp->bh_flags & BH_DIRTY)
@@ -675,6 +765,106 @@ mf_sync(memfile_T *mfp, int flags)
     return status;
 }
 
+#ifdef USE_MF_WRITEV
+/*
+ * Compare function for qsort(), sorts block headers on block number.
+ */
+    static int
+mf_bnum_compare(const void *s1, const void *s2)
+{
+    blocknr_T	n1 = (*(bhdr_T **)s1)->bh_bnum;
+    blocknr_T	n2 = (*(bhdr_T **)s2)->bh_bnum;
+
+    return n1 < n2 ? -1 : n1 > n2 ? 1 : 0;
+}
+
+/*
+ * Write the dirty blocks of memfile "mfp" that already have a place in the
+ * swap file, in order of block number.  Blocks with adjacent numbers are
+ * written with one writev() call, this avoids a system call for every block,
+ * which matters a lot when the swap file is on a network file system.
+ * Block zero, blocks beyond the end of the file and encrypted blocks are left
+ * for mf_write().  When a write fails the blocks stay dirty, mf_write() will
+ * try again and give the error message.
+ * Return FAIL when stopped because of MFS_STOP or CTRL-C, OK otherwise.
+ */
+    static int
+mf_sync_coalesced(memfile_T *mfp, int flags)
+{
+    bhdr_T	**list;
+    bhdr_T	*hp;
+    int		count = 0;
+    int		i, j, n;
+    unsigned	page_size = mfp->mf_page_size;
+    off_T	offset;
+    size_t	size;
+    int		retval = OK;
+    struct iovec iov[MF_WRITEV_MAX];
+
+#ifdef FEAT_CRYPT
+    if (*mfp->mf_buffer->b_p_key != NUL)
+	return OK;
+#endif
+    for (hp = mfp->mf_used_last; hp != NULL; hp = hp->bh_prev)
+	if ((hp->bh_flags & BH_DIRTY) && hp->bh_bnum > 0
+		&& hp->bh_bnum + hp->bh_page_count <= mfp->mf_infile_count)
+	    ++count;
+    if (count < 2)
+	return OK;	    // nothing to combine
+    list = ALLOC_MULT(bhdr_T *, count);
+    if (list == NULL)
+	return OK;
+    count = 0;
+    for (hp = mfp->mf_used_last; hp != NULL; hp = hp->bh_prev)
+	if ((hp->bh_flags & BH_DIRTY) && hp->bh_bnum > 0
+		&& hp->bh_bnum + hp->bh_page_count <= mfp->mf_infile_count
+		&& (!(hp->bh_flags & BH_COMPRESSED)
+					      || mf_decompress(mfp, hp) == OK))
+	    list[count++] = hp;
+    qsort((void *)list, (size_t)count, sizeof(bhdr_T *), mf_bnum_compare);
+
+    for (i = 0; i < count; i = j)
+    {
+	size = 0;
+	for (j = i, n = 0; j < count && n < MF_WRITEV_MAX; ++j, ++n)
+	{
+	    hp = list[j];
+	    if (j > i && hp->bh_bnum != list[j - 1]->bh_bnum
+					     + list[j - 1]->bh_page_count)
+		break;
+	    iov[n].iov_base = (void *)hp->bh_data;
+	    iov[n].iov_len = (size_t)page_size * hp->bh_page_count;
+	    size += iov[n].iov_len;
+	}
+
+	offset = (off_T)page_size * list[i]->bh_bnum;
+	if (vim_lseek(mfp->mf_fd, offset, SEEK_SET) != offset
+		|| writev(mfp->mf_fd, iov, n) != (ssize_t)size)
+	    break;
+	did_swapwrite_msg = FALSE;
+	++mfp->mf_stat_writes;
+	for (n = i; n < j; ++n)
+	    list[n]->bh_flags &= ~BH_DIRTY;
+
+	if (flags & MFS_STOP)
+	{
+	    // Stop when char available now.
+	    if (ui_char_avail())
+		retval = FAIL;
+	}
+	else
+	    ui_breakcheck();
+	if (got_int)
+	    retval = FAIL;
+	if (retval == FAIL)
+	    break;
+    }
+
+    vim_free(list);
+    return retval;
+}
+#endif
+
 /*
  * For all blocks in memory file *mfp that have a positive block number set
  * the dirty flag.  These are blocks that need to be written to a newly
@@ -691,6 +881,266 @@ mf_set_dirty(memfile_T *mfp)
     mfp->mf_dirty = TRUE;
 }
 
+/*
+ * Add "len" literal bytes from "src" to "dst" at "*op".
+ * Return FAIL when that would go past "maxlen".
+ */
+    static int
+mf_lz_literals(char_u *src, int len, char_u *dst, int *op, int maxlen)
+{
+    int	    n;
+
+    while (len > 0)
+    {
+	n = len > MF_LZ_MAXLIT ? MF_LZ_MAXLIT : len;
+	if (*op + 1 + n > maxlen)
+	    return FAIL;
+	dst[(*op)++] = n - 1;
+	mch_memmove(dst + *op, src, (size_t)n);
+	*op += n;
+	src += n;
+	len -= n;
+    }
+    return OK;
+}
+
+/*
+ * Compress "len" bytes from "src" into "dst", which has room for "maxlen"
+ * bytes.
+ * Returns the compressed size, zero when it does not fit in "maxlen".
+ */
+    static int
+mf_lz_compress(char_u *src, int len, char_u *dst, int maxlen)
+{
+    static int	htab[1 << MF_LZ_HASHBITS];
+    int		ip = 0;		// current position in "src"
+    int		lit = 0;	// start of literals not written yet
+    int		op = 0;		// current position in "dst"
+    int		ref;
+    int		mlen;
+    int		i;
+    unsigned	h;
+
+    for (i = 0; i < (1 << MF_LZ_HASHBITS); ++i)
+	htab[i] = -1;
+
+    while (ip + MF_LZ_MINMATCH <= len)
+    {
+	h = ((unsigned)src[ip] | ((unsigned)src[ip + 1] << 8)
+		| ((unsigned)src[ip + 2] << 16) | ((unsigned)src[ip + 3] << 24))
+						* 2654435761U;
+	h = (h & 0xffffffffU) >> (32 - MF_LZ_HASHBITS);
+	ref = htab[h];
+	htab[h] = ip;
+
+	if (ref < 0 || ip - ref > 0xffff
+		     || memcmp(src + ref, src + ip, MF_LZ_MINMATCH) != 0)
+	{
+	    ++ip;
+	    continue;
+	}
+	mlen = MF_LZ_MINMATCH;
+	while (mlen < MF_LZ_MAXMATCH && ip + mlen < len
+					  && src[ref + mlen] == src[ip + mlen])
+	    ++mlen;
+
+	if (mf_lz_literals(src + lit, ip - lit, dst, &op, maxlen) == FAIL
+		|| op + 3 > maxlen)
+	    return 0;
+	dst[op++] = 0x80 | (mlen - MF_LZ_MINMATCH);
+	dst[op++] = (ip - ref) & 0xff;
+	dst[op++] = (ip - ref) >> 8;
+	ip += mlen;
+	lit = ip;
+    }
+
+    if (mf_lz_literals(src + lit, len - lit, dst, &op, maxlen) == FAIL)
+	return 0;
+    return op;
+}
+
+/*
+ * Decompress "len" bytes from "src" into "dst", which must result in exactly
+ * "dstlen" bytes.
+ * Returns FAIL when the data is invalid.
+ */
+    static int
+mf_lz_decompress(char_u *src, int len, char_u *dst, int dstlen)
+{
+    int		ip = 0;
+    int		op = 0;
+    int		c;
+    int		n;
+    int		dist;
+
+    while (ip < len)
+    {
+	c = src[ip++];
+	if (c < 0x80)
+	{
+	    n = c + 1;
+	    if (ip + n > len || op + n > dstlen)
+		return FAIL;
+	    mch_memmove(dst + op, src + ip, (size_t)n);
+	    ip += n;
+	    op += n;
+	}
+	else
+	{
+	    n = (c & 0x7f) + MF_LZ_MINMATCH;
+	    if (ip + 2 > len)
+		return FAIL;
+	    dist = src[ip] | (src[ip + 1] << 8);
+	    ip += 2;
+	    if (dist == 0 || dist > op || op + n > dstlen)
+		return FAIL;
+	    // may overlap, copy byte by byte
+	    for ( ; n > 0; --n, ++op)
+		dst[op] = dst[op - dist];
+	}
+    }
+    return op == dstlen ? OK : FAIL;
+}
+
+/*
+ * Compress the data of the blocks of memfile "mfp" that are in memory and
+ * not locked.  Blocks for which it saves less than a quarter are left alone.
+ * They are decompressed when used again with mf_get() or when written.
+ * With MFS_STOP in "flags" stop when a character becomes available, but
+ * compress at least one block.  The next call continues where it stopped.
+ * Return FAIL when stopped, OK otherwise.
+ */
+    int
+mf_compress(memfile_T *mfp, int flags)
+{
+    int		retval = OK;
+    bhdr_T	*hp;
+    char_u	*buf = NULL;
+    int		buflen = 0;
+    char_u	*p;
+    int		size;
+    int		len;
+    int		from_start = (mfp->mf_compress_next == NULL);
+
+    if (mfp->mf_compress_done)
+	return OK;
+    hp = from_start ? mfp->mf_used_first : mfp->mf_compress_next;
+    mfp->mf_compress_next = NULL;
+    for ( ; hp != NULL; hp = hp->bh_next)
+    {
+	if (hp->bh_flags & (BH_LOCKED | BH_COMPRESSED | BH_NOCOMPRESS))
+	    continue;
+
+	size = hp->bh_page_count * mfp->mf_page_size;
+	if (size > buflen)
+	{
+	    vim_free(buf);
+	    buflen = 0;
+	    if ((buf = alloc(size)) == NULL)
+		break;
+	    buflen = size;
+	}
+
+	len = mf_lz_compress(hp->bh_data, size, buf, size - size / 4);
+	if (len == 0 || (p = alloc(len)) == NULL)
+	    hp->bh_flags |= BH_NOCOMPRESS;
+	else
+	{
+	    mch_memmove(p, buf, (size_t)len);
+	    vim_free(hp->bh_data);
+	    hp->bh_data = p;
+	    hp->bh_comp_len = len;
+	    hp->bh_flags |= BH_COMPRESSED;
+	    mfp->mf_compressed_count += hp->bh_page_count;
+	    total_mem_used -= size - len;
+	}
+
+	// Stop when char available now.
+	if ((flags & MFS_STOP) && ui_char_avail())
+	{
+	    mfp->mf_compress_next = hp->bh_next;
+	    retval = FAIL;
+	    break;
+	}
+    }
+    // When the whole list was done, only mf_put(), mf_ins_used() and
+    // mf_decompress() can add a block to compress.  Blocks before
+    // "mf_compress_next" are checked again the next time.
+    if (hp == NULL && from_start)
+	mfp->mf_compress_done = TRUE;
+    vim_free(buf);
+    return retval;
+}
+
+/*
+ * Restore the data of block "hp" that was compressed by mf_compress().
+ * Returns FAIL when out of memory.
+ */
+    static int
+mf_decompress(memfile_T *mfp, bhdr_T *hp)
+{
+    int		size = hp->bh_page_count * mfp->mf_page_size;
+    char_u	*p;
+
+    if ((p = alloc(size)) == NULL)
+	return FAIL;
+    if (mf_lz_decompress(hp->bh_data, hp->bh_comp_len, p, size) == FAIL)
+    {
+	siemsg(_("E998: Invalid compressed block %ld"), hp->bh_bnum);
+	vim_free(p);
+	return FAIL;
+    }
+    vim_free(hp->bh_data);
+    hp->bh_data = p;
+    hp->bh_flags &= ~BH_COMPRESSED;
+    mfp->mf_compressed_count -= hp->bh_page_count;
+    mfp->mf_compress_done = FALSE;
+    total_mem_used += size - hp->bh_comp_len;
+    return OK;
+}
+
+#if defined(FEAT_EVAL) || defined(PROTO)
+/*
+ * "memfile_stats([{buf}])" function
+ */
+    void
+f_memfile_stats(typval_T *argvars, typval_T *rettv)
+{
+    buf_T	*buf = curbuf;
+    memfile_T	*mfp;
+    dict_T	*d;
+
+    if (rettv_dict_alloc(rettv) != OK)
+	return;
+    if (argvars[0].v_type != VAR_UNKNOWN)
+    {
+	buf = tv_get_buf(&argvars[0], FALSE);
+	if (buf == NULL)
+	    return;
+    }
+    mfp = buf->b_ml.ml_mfp;
+    if (mfp == NULL)
+	return;
+
+    d = rettv->vval.v_dict;
+    dict_add_number(d, "hits", mfp->mf_stat_hits);
+    dict_add_number(d, "misses", mfp->mf_stat_misses);
+    dict_add_number(d, "ghost_hits", mfp->mf_stat_ghost_hits);
+    dict_add_number(d, "evictions", mfp->mf_stat_evictions);
+    dict_add_number(d, "reads", mfp->mf_stat_reads);
+    dict_add_number(d, "writes", mfp->mf_stat_writes);
+    dict_add_number(d, "line_lookups", buf->b_ml.ml_stat_lookups);
+    dict_add_number(d, "locked_hits", buf->b_ml.ml_stat_locked_hits);
+    dict_add_number(d, "block_cache_hits", buf->b_ml.ml_stat_cache_hits);
+    dict_add_number(d, "used_pages", mfp->mf_used_count);
+    dict_add_number(d, "probation_pages", mfp->mf_probation_count);
+    dict_add_number(d, "compressed_pages", mfp->mf_compressed_count);
+    dict_add_number(d, "max_pages", mfp->mf_used_count_max);
+    dict_add_number(d, "page_size", mfp->mf_page_size);
+    dict_add_number(d, "swapfile", mfp->mf_fd >= 0);
+}
+#endif
+
 /*
  * insert block *hp in front of hashlist of memfile *mfp
  */
@@ -719,19 +1169,44 @@ mf_find_hash(memfile_T *mfp, blocknr_T nr)
 }
 
 /*
- * insert block *hp in front of used list of memfile *mfp
+ * insert block *hp in front of used list of memfile *mfp when it is hot,
+ * otherwise in front of the probation part
  */
     static void
 mf_ins_used(memfile_T *mfp, bhdr_T *hp)
 {
-    hp->bh_next = mfp->mf_used_first;
-    mfp->mf_used_first = hp;
-    hp->bh_prev = NULL;
-    if (hp->bh_next == NULL)	    /* list was empty, adjust last pointer */
-	mfp->mf_used_last = hp;
+    if (hp->bh_flags & BH_HOT)
+    {
+	hp->bh_next = mfp->mf_used_first;
+	mfp->mf_used_first = hp;
+	hp->bh_prev = NULL;
+	if (hp->bh_next == NULL)    /* list was empty, adjust last pointer */
+	    mfp->mf_used_last = hp;
+	else
+	    hp->bh_next->bh_prev = hp;
+    }
     else
-	hp->bh_next->bh_prev = hp;
+    {
+	hp->bh_next = mfp->mf_used_mid;
+	if (hp->bh_next == NULL)    /* no probation blocks, append */
+	{
+	    hp->bh_prev = mfp->mf_used_last;
+	    mfp->mf_used_last = hp;
+	}
+	else
+	{
+	    hp->bh_prev = hp->bh_next->bh_prev;
+	    hp->bh_next->bh_prev = hp;
+	}
+	if (hp->bh_prev == NULL)
+	    mfp->mf_used_first = hp;
+	else
+	    hp->bh_prev->bh_next = hp;
+	mfp->mf_used_mid = hp;
+	mfp->mf_probation_count += hp->bh_page_count;
+    }
     mfp->mf_used_count += hp->bh_page_count;
+    mfp->mf_compress_done = FALSE;
     total_mem_used += hp->bh_page_count * mfp->mf_page_size;
 }
 
@@ -741,6 +1216,12 @@ mf_ins_used(memfile_T *mfp, bhdr_T *hp)
     static void
 mf_rem_used(memfile_T *mfp, bhdr_T *hp)
 {
+    if (hp == mfp->mf_used_mid)
+	mfp->mf_used_mid = hp->bh_next;
+    if (hp == mfp->mf_compress_next)
+	mfp->mf_compress_next = hp->bh_next;
+    if (!(hp->bh_flags & BH_HOT))
+	mfp->mf_probation_count -= hp->bh_page_count;
     if (hp->bh_next == NULL)	    /* last block in used list */
 	mfp->mf_used_last = hp->bh_prev;
     else
@@ -750,7 +1231,94 @@ mf_rem_used(memfile_T *mfp, bhdr_T *hp)
     else
 	hp->bh_prev->bh_next = hp->bh_next;
     mfp->mf_used_count -= hp->bh_page_count;
-    total_mem_used -= hp->bh_page_count * mfp->mf_page_size;
+    if (hp->bh_flags & BH_COMPRESSED)
+	mfp->mf_compressed_count -= hp->bh_page_count;
+    total_mem_used -= MF_BLOCK_MEM(mfp, hp);
+}
+
+/*
+ * Remember that block "nr" was released from probation.  When the ghost list
+ * is full the oldest entry is dropped.
+ */
+    static void
+mf_ghost_add(memfile_T *mfp, blocknr_T nr)
+{
+    mf_ghost_T	*gp;
+
+    if (MF_GHOST_MAX(mfp) == 0
+	    || mf_hash_find(&mfp->mf_ghost, nr) != NULL)
+	return;
+    if (mfp->mf_ghost.mht_count >= MF_GHOST_MAX(mfp))
+    {
+	/* re-use the oldest entry */
+	gp = mfp->mf_ghost_first;
+	mf_hash_rem_item(&mfp->mf_ghost, (mf_hashitem_T *)gp);
+	mfp->mf_ghost_first = gp->mg_next;
+	if (gp->mg_next == NULL)
+	    mfp->mf_ghost_last = NULL;
+	else
+	    gp->mg_next->mg_prev = NULL;
+    }
+    else if ((gp = ALLOC_ONE(mf_ghost_T)) == NULL)
+	return;
+    gp->mg_bnum = nr;
+    gp->mg_next = NULL;
+    gp->mg_prev = mfp->mf_ghost_last;
+    if (gp->mg_prev == NULL)
+	mfp->mf_ghost_first = gp;
+    else
+	gp->mg_prev->mg_next = gp;
+    mfp->mf_ghost_last = gp;
+    mf_hash_add_item(&mfp->mf_ghost, (mf_hashitem_T *)gp);
+}
+
+/*
+ * Remove block "nr" from the ghost list.
+ * Return TRUE if it was there.
+ */
+    static int
+mf_ghost_del(memfile_T *mfp, blocknr_T nr)
+{
+    mf_ghost_T	*gp;
+
+    gp = (mf_ghost_T *)mf_hash_find(&mfp->mf_ghost, nr);
+    if (gp == NULL)
+	return FALSE;
+    mf_hash_rem_item(&mfp->mf_ghost, (mf_hashitem_T *)gp);
+    if (gp->mg_prev == NULL)
+	mfp->mf_ghost_first = gp->mg_next;
+    else
+	gp->mg_prev->mg_next = gp->mg_next;
+    if (gp->mg_next == NULL)
+	mfp->mf_ghost_last = gp->mg_prev;
+    else
+	gp->mg_next->mg_prev = gp->mg_prev;
+    vim_free(gp);
+    return TRUE;
+}
+
+/*
+ * Find the least recently used block that is not locked, in the hot part of
+ * the used list when "hot" is TRUE, in the probation part otherwise.
+ */
+    static bhdr_T *
+mf_find_release(memfile_T *mfp, int hot)
+{
+    bhdr_T	*hp;
+
+    if (hot)
+	hp = mfp->mf_used_mid == NULL ? mfp->mf_used_last
+					       : mfp->mf_used_mid->bh_prev;
+    else
+	hp = mfp->mf_used_mid == NULL ? NULL : mfp->mf_used_last;
+    for ( ; hp != NULL; hp = hp->bh_prev)
+    {
+	if (hot != ((hp->bh_flags & BH_HOT) != 0))
+	    return NULL;
+	if (!(hp->bh_flags & BH_LOCKED))
+	    return hp;
+    }
+    return NULL;
 }
 
 /*
@@ -767,6 +1335,7 @@ mf_release(memfile_T *mfp, int page_count)
 {
     bhdr_T	*hp;
     int		need_release;
+    int		probation;
     buf_T	*buf;
 
     /* don't release while in mf_close_file() */
@@ -805,9 +1374,12 @@ mf_release(memfile_T *mfp, int page_count)
     if (mfp->mf_fd < 0 || !need_release)
 	return NULL;
 
-    for (hp = mfp->mf_used_last; hp != NULL; hp = hp->bh_prev)
-	if (!(hp->bh_flags & BH_LOCKED))
-	    break;
+    /* Release from the probation part when it is big, so that hot blocks
+     * are kept. */
+    probation = mfp->mf_probation_count > MF_PROBATION_MAX(mfp);
+    hp = mf_find_release(mfp, !probation);
+    if (hp == NULL)
+	hp = mf_find_release(mfp, probation);
     if (hp == NULL)	/* not a single one that can be released */
 	return NULL;
 
@@ -818,6 +1390,11 @@ mf_release(memfile_T *mfp, int page_count)
     if ((hp->bh_flags & BH_DIRTY) && mf_write(mfp, hp) == FAIL)
 	return NULL;
 
+    /* mf_write() may have changed the block number, remember it after */
+    if (!(hp->bh_flags & BH_HOT))
+	mf_ghost_add(mfp, hp->bh_bnum);
+    ++mfp->mf_stat_evictions;
+
     mf_rem_used(mfp, hp);
     mf_rem_hash(mfp, hp);
 
@@ -825,7 +1402,7 @@ mf_release(memfile_T *mfp, int page_count)
      * If a bhdr_T is returned, make sure that the page_count of bh_data is
      * right
      */
-    if (hp->bh_page_count != page_count)
+    if (hp->bh_page_count != page_count || (hp->bh_flags & BH_COMPRESSED))
     {
 	vim_free(hp->bh_data);
 	if ((hp->bh_data = alloc(mfp->mf_page_size * page_count)) == NULL)
@@ -967,6 +1544,7 @@ mf_read(memfile_T *mfp, bhdr_T *hp)
 	PERROR(_("E295: Read error in swap file"));
 	return FAIL;
     }
+    ++mfp->mf_stat_reads;
 
 #ifdef FEAT_CRYPT
     /* Decrypt if 'key' is set and this is a data block. And when changing the
@@ -1067,6 +1645,7 @@ mf_write(memfile_T *mfp, bhdr_T *hp)
 	}
 
 	did_swapwrite_msg = FALSE;
+	++mfp->mf_stat_writes;
 	if (hp2 != NULL)		    /* written a non-dummy block */
 	    hp2->bh_flags &= ~BH_DIRTY;
 					    /* appended to the file */
@@ -1090,9 +1669,13 @@ mf_write_block(
     off_T	offset UNUSED,
     unsigned	size)
 {
-    char_u	*data = hp->bh_data;
+    char_u	*data;
     int		result = OK;
 
+    if ((hp->bh_flags & BH_COMPRESSED) && mf_decompress(mfp, hp) == FAIL)
+	return FAIL;
+    data = hp->bh_data;
+
 #ifdef FEAT_CRYPT
     /* Encrypt if 'key' is set and this is a data block. */
     if (*mfp->mf_buffer->b_p_key != NUL)
@@ -249,6 +249,7 @@ static void ml_flush_line(buf_T *);
 static bhdr_T *ml_new_data(memfile_T *, int, int);
 static bhdr_T *ml_new_ptr(memfile_T *);
 static bhdr_T *ml_find_line(buf_T *, linenr_T, int);
+static void ml_block_cache_clear(buf_T *buf);
 static int ml_add_stack(buf_T *);
 static void ml_lineadd(buf_T *, int);
 static int b0_magic_wrong(ZERO_BL *);
@@ -261,8 +262,14 @@ static long char_to_long(char_u *);
 static cryptstate_T *ml_crypt_prepare(memfile_T *mfp, off_T offset, int reading);
 #endif
 #ifdef FEAT_BYTEOFF
+static void ml_chunktree_add(buf_T *buf, int idx, int numlines, long size);
+static int ml_chunktree_find(buf_T *buf, linenr_T lnum, long offset, int ffdos, linenr_T *linep, long *sizep);
 static void ml_updatechunk(buf_T *buf, long line, long len, int updtype);
 #endif
+#ifdef FEAT_TEXT_PROP
+static void ml_prop_line_set(buf_T *buf, linenr_T lnum, int has_props);
+static void ml_prop_lines_adjust(buf_T *buf, linenr_T lnum, int amount);
+#endif
 
 /*
  * Open a new memline for "buf".
@@ -286,8 +293,17 @@ ml_open(buf_T *buf)
     buf->b_ml.ml_stack_top = 0;	/* nothing in the stack */
     buf->b_ml.ml_locked = NULL;	/* no cached block */
     buf->b_ml.ml_line_lnum = 0;	/* no cached line */
+    ml_block_cache_clear(buf);
+    buf->b_ml.ml_stat_lookups = 0;
+    buf->b_ml.ml_stat_locked_hits = 0;
+    buf->b_ml.ml_stat_cache_hits = 0;
 #ifdef FEAT_BYTEOFF
     buf->b_ml.ml_chunksize = NULL;
+    buf->b_ml.ml_chunktree = NULL;
+    buf->b_ml.ml_chunktree_ok = FALSE;
+#endif
+#ifdef FEAT_TEXT_PROP
+    ga_init2(&buf->b_ml.ml_prop_lines, sizeof(linenr_T), 100);
 #endif
 
     if (cmdmod.noswapfile)
@@ -847,6 +863,11 @@ ml_close(buf_T *buf, int del_file)
     vim_free(buf->b_ml.ml_stack);
 #ifdef FEAT_BYTEOFF
     VIM_CLEAR(buf->b_ml.ml_chunksize);
+    VIM_CLEAR(buf->b_ml.ml_chunktree);
+    buf->b_ml.ml_chunktree_ok = FALSE;
+#endif
+#ifdef FEAT_TEXT_PROP
+    ga_clear(&buf->b_ml.ml_prop_lines);
 #endif
     buf->b_ml.ml_mfp = NULL;
 
@@ -1201,6 +1222,7 @@ ml_recover(int checkext)
     buf->b_ml.ml_line_lnum = 0;		/* no cached line */
     buf->b_ml.ml_locked = NULL;		/* no locked block */
     buf->b_ml.ml_flags = 0;
+    ml_block_cache_clear(buf);
 #ifdef FEAT_CRYPT
     buf->b_p_key = empty_option;
     buf->b_p_cm = empty_option;
@@ -2469,6 +2491,32 @@ ml_sync_all(int check_file, int check_char)
     }
 }
 
+/*
+ * When 'compresshidden' is set compress the blocks in memory of the loaded
+ * buffers that are not displayed in a window.  Called when waiting for the
+ * user to type something.
+ */
+    void
+ml_compress_hidden(void)
+{
+    buf_T	*buf;
+
+    if (!p_chi)
+	return;
+    FOR_ALL_BUFFERS(buf)
+    {
+	if (buf->b_nwindows > 0 || buf == curbuf
+					       || buf->b_ml.ml_mfp == NULL)
+	    continue;
+
+	ml_flush_line(buf);		    // flush buffered line
+	(void)ml_find_line(buf, (linenr_T)0, ML_FLUSH);	// flush locked block
+	if (mf_compress(buf->b_ml.ml_mfp, MFS_STOP) == FAIL
+		|| ui_char_avail())	    // character available now
+	    break;
+    }
+}
+
 /*
  * sync one buffer, including negative blocks
  *
@@ -2505,6 +2553,7 @@ ml_preserve(buf_T *buf, int message)
 
     /* stack is invalid after mf_sync(.., MFS_ALL) */
     buf->b_ml.ml_stack_top = 0;
+    ml_block_cache_clear(buf);
 
     /*
      * Some of the data blocks may have been changed from negative to
@@ -2537,6 +2586,7 @@ ml_preserve(buf_T *buf, int message)
 	if (mf_sync(mfp, MFS_ALL | MFS_FLUSH) == FAIL)
 	    status = FAIL;
 	buf->b_ml.ml_stack_top = 0;	    /* stack is invalid now */
+	ml_block_cache_clear(buf);
     }
 theend:
     got_int |= got_int_save;
@@ -3261,6 +3311,14 @@ ml_append_int(
     /* The line was inserted below 'lnum' */
     ml_updatechunk(buf, lnum + 1, (long)len, ML_CHNK_ADDLINE);
 #endif
+#ifdef FEAT_TEXT_PROP
+    if (buf->b_has_textprop)
+    {
+	ml_prop_lines_adjust(buf, lnum + 1, 1);
+	if (len > (colnr_T)STRLEN(line) + 1)
+	    ml_prop_line_set(buf, lnum + 1, TRUE);
+    }
+#endif
 #ifdef FEAT_NETBEANS_INTG
     if (netbeans_active())
     {
@@ -3356,6 +3414,137 @@ ml_append_buf(
 }
 #endif
 
+/*
+ * Copy as many of the "count" lines in "lines" as fit into the locked data
+ * block, when "lnum" is the last line in it.  This is what ml_append_int()
+ * does for each line, without going through ml_find_line() every time.
+ * Returns the number of lines appended, zero when this can't be done.
+ */
+    static long
+ml_append_fill(
+    buf_T	*buf,
+    linenr_T	lnum,		// append after this line
+    char_u	**lines,
+    long	count,
+    int		newfile)
+{
+    DATA_BL	*dp;
+    colnr_T	len;
+    int		idx;
+    long	done = 0;
+
+    // The stack must lead to the locked block, the pointer blocks are
+    // updated with ml_locked_lineadd later.
+    if (buf->b_ml.ml_locked == NULL || mf_dont_release
+	    || (buf->b_ml.ml_flags & (ML_EMPTY | ML_LOCKED_NOSTACK))
+	    || lnum != buf->b_ml.ml_locked_high
+	    || lnum < buf->b_ml.ml_locked_low)
+	return 0;
+#ifdef FEAT_TEXT_PROP
+    if (curbuf->b_has_textprop || buf->b_has_textprop)
+	return 0;
+#endif
+#ifdef FEAT_NETBEANS_INTG
+    if (netbeans_active())
+	return 0;
+#endif
+
+    if (lowest_marked && lowest_marked > lnum)
+	lowest_marked = lnum + 1;
+
+    dp = (DATA_BL *)(buf->b_ml.ml_locked->bh_data);
+    for (done = 0; done < count; ++done)
+    {
+	len = (colnr_T)STRLEN(lines[done]) + 1;
+	if ((int)dp->db_free < len + (int)INDEX_SIZE)
+	    break;
+
+	// The line goes at the end, which is the start of the text.
+	idx = buf->b_ml.ml_locked_high - buf->b_ml.ml_locked_low + 1;
+	dp->db_txt_start -= len;
+	dp->db_free -= len + INDEX_SIZE;
+	++(dp->db_line_count);
+	dp->db_index[idx] = dp->db_txt_start;
+	mch_memmove((char *)dp + dp->db_txt_start, lines[done], (size_t)len);
+
+	++(buf->b_ml.ml_locked_lineadd);
+	++(buf->b_ml.ml_locked_high);
+	++(buf->b_ml.ml_line_count);
+#ifdef FEAT_BYTEOFF
+	ml_updatechunk(buf, lnum + done + 1, (long)len, ML_CHNK_ADDLINE);
+#endif
+    }
+
+    if (done > 0)
+    {
+	buf->b_ml.ml_flags |= ML_LOCKED_DIRTY;
+	if (!newfile)
+	    buf->b_ml.ml_flags |= ML_LOCKED_POS;
+	ml_block_cache_clear(buf);
+    }
+    return done;
+}
+
+/*
+ * Append "count" lines from "lines" after line "lnum" in buffer "buf", which
+ * must have a memline.  Works like calling ml_append_buf() for each line, but
+ * the cached line is flushed and listeners are checked only once, and lines
+ * are copied into the data block directly while they fit.
+ * Check: The caller of this function should probably also call
+ * appended_lines_mark().
+ *
+ * Return the number of lines appended, less than "count" for failure.
+ */
+    long
+ml_append_lines(
+    buf_T	*buf,
+    linenr_T	lnum,		// append after this line (can be 0)
+    char_u	**lines,	// texts of the new lines
+    long	count,		// number of lines in "lines"
+    int		newfile)	// flag, see ml_append()
+{
+    long	done = 0;
+    long	n;
+
+    if (buf->b_ml.ml_mfp == NULL || lnum > buf->b_ml.ml_line_count
+								|| count <= 0)
+	return 0;
+
+    if (buf->b_ml.ml_line_lnum != 0)
+	// This may also invoke ml_append_int().
+	ml_flush_line(buf);
+
+#ifdef FEAT_EVAL
+    // When inserting above recorded changes: flush the changes before changing
+    // the text.  Then flush the cached line, it may become invalid.
+    may_invoke_listeners(buf, lnum + 1, lnum + 1, (int)count);
+    if (buf->b_ml.ml_line_lnum != 0)
+	ml_flush_line(buf);
+#endif
+
+    while (done < count)
+    {
+	n = ml_append_fill(buf, lnum + done, lines + done, count - done,
+								     newfile);
+	if (n == 0)
+	{
+	    // Does not fit or not at the end of the block, this finds the
+	    // block and splits it when needed.
+	    if (ml_append_int(buf, lnum + done, lines[done], (colnr_T)0,
+						     newfile, FALSE) == FAIL)
+		break;
+	    n = 1;
+	}
+	done += n;
+    }
+
+#ifdef FEAT_JOB_CHANNEL
+    if (done > 0 && buf->b_write_to_channel)
+	channel_write_new_lines(buf);
+#endif
+    return done;
+}
+
 /*
  * Replace line lnum, with buffering, in current buffer.
  *
@@ -3657,6 +3846,13 @@ ml_delete_int(buf_T *buf, linenr_T lnum, int message)
     idx = lnum - buf->b_ml.ml_locked_low;
 
     --buf->b_ml.ml_line_count;
+#ifdef FEAT_TEXT_PROP
+    if (buf->b_has_textprop)
+    {
+	ml_prop_line_set(buf, lnum, FALSE);
+	ml_prop_lines_adjust(buf, lnum + 1, -1);
+    }
+#endif
 
     line_start = ((dp->db_index[idx]) & DB_INDEX_MASK);
     if (idx == 0)		/* first line in block, text at the end */
@@ -3931,6 +4127,11 @@ ml_flush_line(buf_T *buf)
 
 	lnum = buf->b_ml.ml_line_lnum;
 	new_line = buf->b_ml.ml_line_ptr;
+#ifdef FEAT_TEXT_PROP
+	if (buf->b_has_textprop)
+	    ml_prop_line_set(buf, lnum, buf->b_ml.ml_line_len
+					     > (colnr_T)STRLEN(new_line) + 1);
+#endif
 
 	hp = ml_find_line(buf, lnum, ML_FIND);
 	if (hp == NULL)
@@ -4085,9 +4286,19 @@ ml_find_line(buf_T *buf, linenr_T lnum, int action)
      * Don't do this for ML_FLUSH, because we want to flush the locked block.
      * Don't do this when 'swapfile' is reset, we want to load all the blocks.
      */
+    if (action == ML_FIND)
+	++buf->b_ml.ml_stat_lookups;
+    else
+	// Line numbers are going to change.
+	ml_block_cache_clear(buf);
+
     if (buf->b_ml.ml_locked)
     {
+	/* When ml_locked was found in ml_block_cache the stack can't be used
+	 * for updating the pointer blocks. */
 	if (ML_SIMPLE(action)
+		&& (action == ML_FIND
+			  || !(buf->b_ml.ml_flags & ML_LOCKED_NOSTACK))
 		&& buf->b_ml.ml_locked_low <= lnum
 		&& buf->b_ml.ml_locked_high >= lnum
 		&& !mf_dont_release)
@@ -4103,6 +4314,8 @@ ml_find_line(buf_T *buf, linenr_T lnum, int action)
 		--(buf->b_ml.ml_locked_lineadd);
 		--(buf->b_ml.ml_locked_high);
 	    }
+	    else
+		++buf->b_ml.ml_stat_locked_hits;
 	    return (buf->b_ml.ml_locked);
 	}
 
@@ -4126,6 +4339,38 @@ ml_find_line(buf_T *buf, linenr_T lnum, int action)
     low = 1;
     high = buf->b_ml.ml_line_count;
 
+    if (action == ML_FIND && !mf_dont_release)
+    {
+	/* Try the recently used data blocks. */
+	for (idx = 0; idx < ML_BLOCK_CACHE_SIZE; ++idx)
+	{
+	    mlblock_T *mbp = &buf->b_ml.ml_block_cache[idx];
+
+	    if (mbp->mb_bnum != 0 && mbp->mb_low <= lnum
+						     && mbp->mb_high >= lnum)
+	    {
+		if ((hp = mf_get(mfp, mbp->mb_bnum, mbp->mb_page_count))
+								       == NULL)
+		    break;
+		if (((DATA_BL *)(hp->bh_data))->db_id != DATA_ID)
+		{
+		    // can't happen
+		    mf_put(mfp, hp, FALSE, FALSE);
+		    ml_block_cache_clear(buf);
+		    break;
+		}
+		++buf->b_ml.ml_stat_cache_hits;
+		buf->b_ml.ml_locked = hp;
+		buf->b_ml.ml_locked_low = mbp->mb_low;
+		buf->b_ml.ml_locked_high = mbp->mb_high;
+		buf->b_ml.ml_locked_lineadd = 0;
+		buf->b_ml.ml_flags &= ~(ML_LOCKED_DIRTY | ML_LOCKED_POS);
+		buf->b_ml.ml_flags |= ML_LOCKED_NOSTACK;
+		return hp;
+	    }
+	}
+    }
+
     if (action == ML_FIND)	/* first try stack entries */
     {
 	for (top = buf->b_ml.ml_stack_top - 1; top >= 0; --top)
@@ -4169,7 +4414,23 @@ ml_find_line(buf_T *buf, linenr_T lnum, int action)
 	    buf->b_ml.ml_locked_low = low;
 	    buf->b_ml.ml_locked_high = high;
 	    buf->b_ml.ml_locked_lineadd = 0;
-	    buf->b_ml.ml_flags &= ~(ML_LOCKED_DIRTY | ML_LOCKED_POS);
+	    buf->b_ml.ml_flags &= ~(ML_LOCKED_DIRTY | ML_LOCKED_POS
+							 | ML_LOCKED_NOSTACK);
+
+	    /* Remember where the block is.  A block with a negative number
+	     * may get another number when it is written. */
+	    if (action == ML_FIND && bnum > 0)
+	    {
+		mlblock_T *mbp = &buf->b_ml.ml_block_cache[
+					       buf->b_ml.ml_block_cache_next];
+
+		mbp->mb_bnum = bnum;
+		mbp->mb_page_count = page_count;
+		mbp->mb_low = low;
+		mbp->mb_high = high;
+		buf->b_ml.ml_block_cache_next =
+			 (buf->b_ml.ml_block_cache_next + 1) % ML_BLOCK_CACHE_SIZE;
+	    }
 	    return hp;
 	}
 
@@ -4257,6 +4518,17 @@ error_noblock:
     return NULL;
 }
 
+/*
+ * Forget the locations of data blocks remembered by ml_find_line().  Must be
+ * done when line numbers change or blocks may be freed.
+ */
+    static void
+ml_block_cache_clear(buf_T *buf)
+{
+    vim_memset(buf->b_ml.ml_block_cache, 0, sizeof(buf->b_ml.ml_block_cache));
+    buf->b_ml.ml_block_cache_next = 0;
+}
+
 /*
  * add an entry to the info pointer stack
  *
@@ -5408,12 +5680,269 @@ ml_crypt_prepare(memfile_T *mfp, off_T offset, int reading)
 
 #endif
 
+#if defined(FEAT_TEXT_PROP) || defined(PROTO)
+/*
+ * The line numbers of the lines that have text properties are kept in
+ * ml_prop_lines, sorted, so that functions working on a range of lines only
+ * need to look at the lines with text properties.  It is updated when a line
+ * is inserted, deleted or the cached line is flushed.
+ */
+
+/*
+ * Return the index in ml_prop_lines of the first line at or after "lnum".
+ */
+    static int
+ml_prop_line_idx(buf_T *buf, linenr_T lnum)
+{
+    linenr_T	*lines = (linenr_T *)buf->b_ml.ml_prop_lines.ga_data;
+    int		lo = 0;
+    int		hi = buf->b_ml.ml_prop_lines.ga_len;
+    int		mid;
+
+    while (lo < hi)
+    {
+	mid = (lo + hi) / 2;
+	if (lines[mid] < lnum)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+    return lo;
+}
+
+/*
+ * Set whether line "lnum" has text properties.
+ */
+    static void
+ml_prop_line_set(buf_T *buf, linenr_T lnum, int has_props)
+{
+    garray_T	*gap = &buf->b_ml.ml_prop_lines;
+    int		idx = ml_prop_line_idx(buf, lnum);
+    linenr_T	*lines;
+
+    if (idx < gap->ga_len && ((linenr_T *)gap->ga_data)[idx] == lnum)
+    {
+	if (!has_props)
+	{
+	    lines = (linenr_T *)gap->ga_data;
+	    mch_memmove(lines + idx, lines + idx + 1,
+				   (gap->ga_len - idx - 1) * sizeof(linenr_T));
+	    --gap->ga_len;
+	}
+    }
+    else if (has_props && ga_grow(gap, 1) == OK)
+    {
+	lines = (linenr_T *)gap->ga_data;
+	mch_memmove(lines + idx + 1, lines + idx,
+				       (gap->ga_len - idx) * sizeof(linenr_T));
+	lines[idx] = lnum;
+	++gap->ga_len;
+    }
+}
+
+/*
+ * Add "amount" to the line numbers at or after "lnum", for inserted or
+ * deleted lines.
+ */
+    static void
+ml_prop_lines_adjust(buf_T *buf, linenr_T lnum, int amount)
+{
+    linenr_T	*lines = (linenr_T *)buf->b_ml.ml_prop_lines.ga_data;
+    int		idx;
+
+    for (idx = ml_prop_line_idx(buf, lnum);
+				 idx < buf->b_ml.ml_prop_lines.ga_len; ++idx)
+	lines[idx] += amount;
+}
+
+/*
+ * Return the first line at or after "lnum" in buffer "buf" that may have
+ * text properties.  Returns zero when there is none.
+ */
+    linenr_T
+ml_next_prop_line(buf_T *buf, linenr_T lnum)
+{
+    garray_T	*gap = &buf->b_ml.ml_prop_lines;
+    int		idx;
+    linenr_T	next = 0;
+
+    if (!buf->b_has_textprop || buf->b_ml.ml_mfp == NULL
+					     || lnum > buf->b_ml.ml_line_count)
+	return 0;
+    idx = ml_prop_line_idx(buf, lnum);
+    if (idx < gap->ga_len)
+	next = ((linenr_T *)gap->ga_data)[idx];
+
+    // The cached line may have been changed without updating the list.
+    if ((buf->b_ml.ml_flags & ML_LINE_DIRTY)
+	    && buf->b_ml.ml_line_lnum >= lnum
+	    && (next == 0 || buf->b_ml.ml_line_lnum < next))
+	next = buf->b_ml.ml_line_lnum;
+    return next;
+}
+#endif
 
 #if defined(FEAT_BYTEOFF) || defined(PROTO)
 
 #define MLCS_MAXL 800	/* max no of lines in chunk */
 #define MLCS_MINL 400   /* should be half of MLCS_MAXL */
 
+/*
+ * Besides the array of chunks a Fenwick tree (binary indexed tree) is kept,
+ * so that the chunk holding a line or byte offset is found and the size of a
+ * chunk is changed in O(log n) time, also for buffers with many chunks.
+ * Entry "i" of ml_chunktree holds the sum of the chunks "i - (i & -i)" up to
+ * "i - 1".  Entry zero is not used.
+ * Splitting and joining chunks invalidates the tree, it is rebuilt in O(n)
+ * time when it is needed again.  That happens at most once for every few
+ * hundred lines that are inserted or deleted.
+ */
+
+/*
+ * Make ml_chunktree valid for the current chunks.
+ * Return FAIL when out of memory.
+ */
+    static int
+ml_chunktree_build(buf_T *buf)
+{
+    chunksize_T	*tree;
+    int		n = buf->b_ml.ml_usedchunks;
+    int		i, j;
+
+    if (buf->b_ml.ml_chunktree_ok)
+	return OK;
+    if (buf->b_ml.ml_chunktree == NULL)
+    {
+	buf->b_ml.ml_chunktree = ALLOC_MULT(chunksize_T,
+						   buf->b_ml.ml_numchunks + 1);
+	if (buf->b_ml.ml_chunktree == NULL)
+	    return FAIL;
+    }
+    tree = buf->b_ml.ml_chunktree;
+    mch_memmove(tree + 1, buf->b_ml.ml_chunksize, n * sizeof(chunksize_T));
+    for (i = 1; i <= n; ++i)
+    {
+	j = i + (i & -i);
+	if (j <= n)
+	{
+	    tree[j].mlcs_numlines += tree[i].mlcs_numlines;
+	    tree[j].mlcs_totalsize += tree[i].mlcs_totalsize;
+	}
+    }
+    buf->b_ml.ml_chunktree_ok = TRUE;
+    return OK;
+}
+
+/*
+ * Add "numlines" and "size" to chunk "idx" in ml_chunktree.  Must be called
+ * after changing the chunk in ml_chunksize.
+ */
+    static void
+ml_chunktree_add(buf_T *buf, int idx, int numlines, long size)
+{
+    chunksize_T	*tree = buf->b_ml.ml_chunktree;
+    int		i;
+
+    if (!buf->b_ml.ml_chunktree_ok)
+	return;		// will be rebuilt when needed
+    for (i = idx + 1; i <= buf->b_ml.ml_usedchunks; i += i & -i)
+    {
+	tree[i].mlcs_numlines += numlines;
+	tree[i].mlcs_totalsize += size;
+    }
+}
+
+/*
+ * Add an entry to ml_chunktree for the last chunk in ml_chunksize, which was
+ * just added.
+ */
+    static void
+ml_chunktree_append(buf_T *buf)
+{
+    chunksize_T	*tree = buf->b_ml.ml_chunktree;
+    int		n = buf->b_ml.ml_usedchunks;
+    int		j;
+
+    if (!buf->b_ml.ml_chunktree_ok)
+	return;
+    if (n >= buf->b_ml.ml_numchunks + 1)
+    {
+	// no room, the tree was allocated for fewer chunks
+	buf->b_ml.ml_chunktree_ok = FALSE;
+	return;
+    }
+    // The new entry covers the chunk itself and the entries of the tree
+    // for the chunks before it within its range.
+    tree[n] = buf->b_ml.ml_chunksize[n - 1];
+    for (j = n - 1; j > n - (n & -n); j -= j & -j)
+    {
+	tree[n].mlcs_numlines += tree[j].mlcs_numlines;
+	tree[n].mlcs_totalsize += tree[j].mlcs_totalsize;
+    }
+}
+
+/*
+ * Find the chunk containing line "lnum" (when not zero) or byte "offset"
+ * (when not zero).  When "ffdos" is TRUE a CR is counted for each line when
+ * looking for "offset".  The last chunk is never skipped.
+ * Sets "*linep" to the first line in the chunk and "*sizep" to the number of
+ * bytes before it, not counting CRs.
+ * Returns the index of the chunk.
+ */
+    static int
+ml_chunktree_find(
+    buf_T	*buf,
+    linenr_T	lnum,
+    long	offset,
+    int		ffdos,
+    linenr_T	*linep,
+    long	*sizep)
+{
+    chunksize_T	*cp;
+    int		n = buf->b_ml.ml_usedchunks - 1;
+    int		pos = 0;
+    int		step;
+    linenr_T	lines = 0;
+    long	size = 0;
+
+    if (ml_chunktree_build(buf) == FAIL)
+    {
+	// Out of memory: go over the chunks one by one.
+	cp = buf->b_ml.ml_chunksize;
+	while (pos < n
+		&& ((lnum != 0 && lnum > lines + cp[pos].mlcs_numlines)
+		    || (offset != 0 && offset > size + cp[pos].mlcs_totalsize
+			     + ffdos * (lines + cp[pos].mlcs_numlines))))
+	{
+	    lines += cp[pos].mlcs_numlines;
+	    size += cp[pos].mlcs_totalsize;
+	    ++pos;
+	}
+    }
+    else
+    {
+	for (step = 1; step * 2 <= n; step *= 2)
+	    ;
+	for ( ; step > 0; step /= 2)
+	{
+	    if (pos + step > n)
+		continue;
+	    cp = buf->b_ml.ml_chunktree + pos + step;
+	    if ((lnum != 0 && lnum > lines + cp->mlcs_numlines)
+		    || (offset != 0 && offset > size + cp->mlcs_totalsize
+				      + ffdos * (lines + cp->mlcs_numlines)))
+	    {
+		pos += step;
+		lines += cp->mlcs_numlines;
+		size += cp->mlcs_totalsize;
+	    }
+	}
+    }
+    *linep = lines + 1;
+    *sizep = size;
+    return pos;
+}
+
 /*
  * Keep information for finding byte offset of a line, updtype may be one of:
  * ML_CHNK_ADDLINE: Add len to parent chunk, possibly splitting it
@@ -5455,6 +5984,7 @@ ml_updatechunk(
 	buf->b_ml.ml_usedchunks = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_totalsize = 1;
+	buf->b_ml.ml_chunktree_ok = FALSE;
     }
 
     if (updtype == ML_CHNK_UPDLINE && buf->b_ml.ml_line_count == 1)
@@ -5465,6 +5995,7 @@ ml_updatechunk(
 	buf->b_ml.ml_usedchunks = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_totalsize = (long)buf->b_ml.ml_line_len;
+	buf->b_ml.ml_chunktree_ok = FALSE;
 	return;
     }
 
@@ -5474,13 +6005,7 @@ ml_updatechunk(
      */
     if (buf != ml_upd_lastbuf || line != ml_upd_lastline + 1
 	    || updtype != ML_CHNK_ADDLINE)
-    {
-	for (curline = 1, curix = 0;
-	     curix < buf->b_ml.ml_usedchunks - 1
-	     && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-	     curix++)
-	    curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    }
+	curix = ml_chunktree_find(buf, line, 0L, FALSE, &curline, &size);
     else if (curix < buf->b_ml.ml_usedchunks - 1
 	      && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
     {
@@ -5493,9 +6018,12 @@ ml_updatechunk(
     if (updtype == ML_CHNK_DELLINE)
 	len = -len;
     curchnk->mlcs_totalsize += len;
-    if (updtype == ML_CHNK_ADDLINE)
+    if (updtype == ML_CHNK_UPDLINE)
+	ml_chunktree_add(buf, curix, 0, len);
+    else if (updtype == ML_CHNK_ADDLINE)
     {
 	curchnk->mlcs_numlines++;
+	ml_chunktree_add(buf, curix, 1, len);
 
 	/* May resize here so we don't have to do it in both cases below */
 	if (buf->b_ml.ml_usedchunks + 1 >= buf->b_ml.ml_numchunks)
@@ -5513,6 +6041,9 @@ ml_updatechunk(
 		buf->b_ml.ml_usedchunks = -1;
 		return;
 	    }
+	    /* The tree is allocated again with the new size when needed. */
+	    VIM_CLEAR(buf->b_ml.ml_chunktree);
+	    buf->b_ml.ml_chunktree_ok = FALSE;
 	}
 
 	if (buf->b_ml.ml_chunksize[curix].mlcs_numlines >= MLCS_MAXL)
@@ -5582,6 +6113,7 @@ ml_updatechunk(
 	    buf->b_ml.ml_chunksize[curix].mlcs_totalsize = size;
 	    buf->b_ml.ml_chunksize[curix + 1].mlcs_totalsize -= size;
 	    buf->b_ml.ml_usedchunks++;
+	    buf->b_ml.ml_chunktree_ok = FALSE;
 	    ml_upd_lastbuf = NULL;   /* Force recalc of curix & curline */
 	    return;
 	}
@@ -5599,6 +6131,7 @@ ml_updatechunk(
 	    {
 		curchnk->mlcs_numlines = 0;
 		curchnk->mlcs_totalsize = 0;
+		ml_chunktree_append(buf);
 	    }
 	    else
 	    {
@@ -5623,12 +6156,17 @@ ml_updatechunk(
 		curchnk->mlcs_numlines = 1;
 		curchnk[-1].mlcs_totalsize -= rest;
 		curchnk[-1].mlcs_numlines -= 1;
+		// The tree entry of the new chunk is set by
+		// ml_chunktree_append(), after updating the previous chunk.
+		ml_chunktree_add(buf, curix, -1, -rest);
+		ml_chunktree_append(buf);
 	    }
 	}
     }
     else if (updtype == ML_CHNK_DELLINE)
     {
 	curchnk->mlcs_numlines--;
+	ml_chunktree_add(buf, curix, -1, len);
 	ml_upd_lastbuf = NULL;   /* Force recalc of curix & curline */
 	if (curix < (buf->b_ml.ml_usedchunks - 1)
 		&& (curchnk->mlcs_numlines + curchnk[1].mlcs_numlines)
@@ -5642,6 +6180,7 @@ ml_updatechunk(
 	    buf->b_ml.ml_usedchunks--;
 	    mch_memmove(buf->b_ml.ml_chunksize, buf->b_ml.ml_chunksize + 1,
 			buf->b_ml.ml_usedchunks * sizeof(chunksize_T));
+	    buf->b_ml.ml_chunktree_ok = FALSE;
 	    return;
 	}
 	else if (curix == 0 || (curchnk->mlcs_numlines > 10
@@ -5655,6 +6194,7 @@ ml_updatechunk(
 	curchnk[-1].mlcs_numlines += curchnk->mlcs_numlines;
 	curchnk[-1].mlcs_totalsize += curchnk->mlcs_totalsize;
 	buf->b_ml.ml_usedchunks--;
+	buf->b_ml.ml_chunktree_ok = FALSE;
 	if (curix < buf->b_ml.ml_usedchunks)
 	{
 	    mch_memmove(buf->b_ml.ml_chunksize + curix,
@@ -5680,7 +6220,6 @@ ml_updatechunk(
 ml_find_line_or_offset(buf_T *buf, linenr_T lnum, long *offp)
 {
     linenr_T	curline;
-    int		curix;
     long	size;
     bhdr_T	*hp;
     DATA_BL	*dp;
@@ -5708,24 +6247,12 @@ ml_find_line_or_offset(buf_T *buf, linenr_T lnum, long *offp)
     if (lnum == 0 && offset <= 0)
 	return 1;   /* Not a "find offset" and offset 0 _must_ be in line 1 */
     /*
-     * Find the last chunk before the one containing our line. Last chunk is
-     * special because it will never qualify
+     * Find the chunk containing our line. Last chunk is special because it
+     * will never be skipped.
      */
-    curline = 1;
-    curix = size = 0;
-    while (curix < buf->b_ml.ml_usedchunks - 1
-	    && ((lnum != 0
-	     && lnum >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
-		|| (offset != 0
-	       && offset > size + buf->b_ml.ml_chunksize[curix].mlcs_totalsize
-		      + ffdos * buf->b_ml.ml_chunksize[curix].mlcs_numlines)))
-    {
-	curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-	size += buf->b_ml.ml_chunksize[curix].mlcs_totalsize;
-	if (offset && ffdos)
-	    size += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-	curix++;
-    }
+    (void)ml_chunktree_find(buf, lnum, offset, ffdos, &curline, &size);
+    if (offset && ffdos)
+	size += curline - 1;
 
     while ((lnum != 0 && curline < lnum) || (offset != 0 && size < offset))
     {
@@ -0,0 +1,196 @@
+/* vi:set ts=8 sts=4 sw=4 noet:
+ *
+ * VIM - Vi IMproved	by Bram Moolenaar
+ *
+ * Do ":help uganda"  in Vim to read copying and usage conditions.
+ * Do ":help credits" in Vim to see a list of people who contributed.
+ * See README.txt for an overview of the Vim source code.
+ */
+
+/*
+ * memline_bench.c: Benchmark for memline.c and memfile.c
+ *
+ * Run with "make bench_memline".  For buffers from 1000 up to 10 million
+ * lines this fills the buffer and then does random ml_get(), ml_replace(),
+ * ml_append(), ml_delete() and line2byte() calls.  For each the number of
+ * operations per second is reported, and for each buffer size the peak
+ * memory used for blocks.  An optional argument sets the maximum number of
+ * lines, e.g. "./memline_bench 100000".
+ */
+
+#include <stdio.h>
+
+/* Must include main.c because it contains much more than just main() */
+#define NO_VIM_MAIN
+#include "main.c"
+
+/* Included for total_mem_used, which is static */
+#include "memfile.c"
+
+#ifdef HAVE_SYS_RESOURCE_H
+# include <sys/resource.h>
+#endif
+
+#define BENCH_FNAME	"Xmemline_bench"
+#define BENCH_OPS	100000L	    // number of random calls of each kind
+#define BENCH_LINE_LEN	200
+
+static long_u	peak_mem_used;
+
+/*
+ * Return a random number from 0 to "n" - 1, also for "n" above RAND_MAX.
+ */
+    static long
+bench_random(long n)
+{
+    return (long)((((long_u)rand() << 15) ^ (long_u)rand()) % (long_u)n);
+}
+
+/*
+ * Put the text for line "n" in "buf".  Lines have different lengths, like
+ * in a source file.
+ */
+    static void
+bench_line(char_u *buf, long n)
+{
+    vim_snprintf((char *)buf, BENCH_LINE_LEN, "%*sline %ld %.*s",
+	    (int)(n % 5) * 4, "", n, (int)(n * 7 % 60),
+	    "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ 01234567");
+}
+
+    static void
+bench_check_mem(void)
+{
+    if (total_mem_used > peak_mem_used)
+	peak_mem_used = total_mem_used;
+}
+
+/*
+ * Report the time it took to do "count" calls of "what" since "tm" was
+ * started.
+ */
+    static void
+bench_report(char *what, long count, proftime_T *tm)
+{
+    float_T	secs;
+
+    profile_end(tm);
+    secs = profile_float(tm);
+    printf("    %-10s %9ld calls %9.3f sec %12.0f calls/sec\n",
+		     what, count, secs, secs > 0 ? (float_T)count / secs : 0.0);
+}
+
+/*
+ * Run the benchmark for a buffer with "lines" lines.
+ */
+    static void
+bench_memline(long lines)
+{
+    char_u	line[BENCH_LINE_LEN];
+    proftime_T	tm;
+    long	i;
+    long	count;
+
+    printf("%ld lines:\n", lines);
+    peak_mem_used = total_mem_used;
+    if (ml_open(curbuf) == FAIL)
+    {
+	printf("    ml_open() failed\n");
+	return;
+    }
+
+    profile_start(&tm);
+    for (i = 1; i <= lines; ++i)
+    {
+	bench_line(line, i);
+	ml_append(i - 1, line, (colnr_T)0, FALSE);
+	bench_check_mem();
+    }
+    bench_report("fill", lines, &tm);
+    count = curbuf->b_ml.ml_line_count;
+
+    srand(1234);
+    profile_start(&tm);
+    for (i = 0; i < BENCH_OPS; ++i)
+    {
+	(void)ml_get((linenr_T)bench_random(count) + 1);
+	bench_check_mem();
+    }
+    bench_report("ml_get", BENCH_OPS, &tm);
+
+    profile_start(&tm);
+    for (i = 0; i < BENCH_OPS; ++i)
+    {
+	bench_line(line, i);
+	ml_replace((linenr_T)bench_random(count) + 1, line, TRUE);
+	bench_check_mem();
+    }
+    bench_report("ml_replace", BENCH_OPS, &tm);
+
+    profile_start(&tm);
+    for (i = 0; i < BENCH_OPS; ++i)
+    {
+	bench_line(line, i);
+	ml_append((linenr_T)bench_random(count + i + 1), line, (colnr_T)0,
+									FALSE);
+	bench_check_mem();
+    }
+    bench_report("ml_append", BENCH_OPS, &tm);
+
+    profile_start(&tm);
+    for (i = 0; i < BENCH_OPS; ++i)
+    {
+	ml_delete((linenr_T)bench_random(count + BENCH_OPS - i) + 1, FALSE);
+	bench_check_mem();
+    }
+    bench_report("ml_delete", BENCH_OPS, &tm);
+
+#ifdef FEAT_BYTEOFF
+    profile_start(&tm);
+    for (i = 0; i < BENCH_OPS; ++i)
+    {
+	(void)ml_find_line_or_offset(curbuf,
+				       (linenr_T)bench_random(count) + 1, NULL);
+	bench_check_mem();
+    }
+    bench_report("line2byte", BENCH_OPS, &tm);
+#endif
+
+    printf("    peak block memory: %lu Kbyte\n", peak_mem_used / 1024);
+    ml_close(curbuf, TRUE);
+}
+
+    int
+main(int argc, char **argv)
+{
+    long	max_lines = 10000000L;
+    long	lines;
+#ifdef HAVE_SYS_RESOURCE_H
+    struct rusage ru;
+#endif
+
+    vim_memset(&params, 0, sizeof(params));
+    params.argc = argc;
+    params.argv = argv;
+    common_init(&params);
+    init_chartab();
+
+    if (argc > 1)
+	max_lines = atol(argv[1]);
+
+    // Use a file name, so that blocks can be written to a swap file when
+    // 'maxmem' is reached.
+    curbuf->b_ffname = vim_strsave((char_u *)BENCH_FNAME);
+    curbuf->b_sfname = vim_strsave((char_u *)BENCH_FNAME);
+    curbuf->b_fname = curbuf->b_sfname;
+    printf("'maxmem' %ld Kbyte, 'maxmemtot' %ld Kbyte\n", p_mm, p_mmt);
+
+    for (lines = 1000; lines <= max_lines; lines *= 10)
+	bench_memline(lines);
+
+#ifdef HAVE_SYS_RESOURCE_H
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+	printf("peak resident memory: %ld Kbyte\n", (long)ru.ru_maxrss);
+#endif
+    return 0;
+}
@@ -0,0 +1,184 @@
+/* vi:set ts=8 sts=4 sw=4 noet:
+ *
+ * VIM - Vi IMproved	by Bram Moolenaar
+ *
+ * Do ":help uganda"  in Vim to read copying and usage conditions.
+ * Do ":help credits" in Vim to see a list of people who contributed.
+ * See README.txt for an overview of the Vim source code.
+ */
+
+/*
+ * memline_test.c: Unittests for memline.c
+ */
+
+#undef NDEBUG
+#include <assert.h>
+
+/* Must include main.c because it contains much more than just main() */
+#define NO_VIM_MAIN
+#include "main.c"
+
+/* This file has to be included because the tested functions are static */
+#include "memline.c"
+
+#define MAX_CHUNKS 1000
+#define TEST_COUNT 20000
+
+/*
+ * Find the chunk for "lnum" or "offset" by going over all chunks, the way it
+ * was done before there was a tree.
+ */
+    static int
+find_chunk_linear(
+    buf_T	*buf,
+    linenr_T	lnum,
+    long	offset,
+    int		ffdos,
+    linenr_T	*linep,
+    long	*sizep)
+{
+    linenr_T	curline = 1;
+    long	size = 0;
+    int		curix = 0;
+    chunksize_T	*cp = buf->b_ml.ml_chunksize;
+
+    while (curix < buf->b_ml.ml_usedchunks - 1
+	    && ((lnum != 0 && lnum >= curline + cp[curix].mlcs_numlines)
+		|| (offset != 0 && offset > size + cp[curix].mlcs_totalsize
+			 + ffdos * (curline - 1 + cp[curix].mlcs_numlines))))
+    {
+	curline += cp[curix].mlcs_numlines;
+	size += cp[curix].mlcs_totalsize;
+	curix++;
+    }
+    *linep = curline;
+    *sizep = size;
+    return curix;
+}
+
+/*
+ * Check that the tree gives the same result as going over the chunks, for
+ * lines and offsets around the start of every chunk.
+ */
+    static void
+check_chunktree(buf_T *buf)
+{
+    linenr_T	total_lines = 0;
+    long	total_size = 0;
+    linenr_T	lnum;
+    linenr_T	line1, line2;
+    long	size1, size2;
+    long	offset;
+    int		ffdos;
+    int		i;
+    int		d;
+
+    for (i = 0; i <= buf->b_ml.ml_usedchunks; ++i)
+    {
+	for (d = -1; d <= 1; ++d)
+	{
+	    lnum = total_lines + 1 + d;
+	    if (lnum > 0)
+	    {
+		assert(ml_chunktree_find(buf, lnum, 0L, FALSE, &line1, &size1)
+		       == find_chunk_linear(buf, lnum, 0L, FALSE,
+							      &line2, &size2));
+		assert(line1 == line2);
+		assert(size1 == size2);
+	    }
+	    for (ffdos = FALSE; ffdos <= TRUE; ++ffdos)
+	    {
+		offset = total_size + ffdos * total_lines + d;
+		if (offset <= 0)
+		    continue;
+		assert(ml_chunktree_find(buf, 0, offset, ffdos, &line1, &size1)
+		       == find_chunk_linear(buf, 0, offset, ffdos,
+							      &line2, &size2));
+		assert(line1 == line2);
+		assert(size1 == size2);
+	    }
+	}
+	if (i < buf->b_ml.ml_usedchunks)
+	{
+	    total_lines += buf->b_ml.ml_chunksize[i].mlcs_numlines;
+	    total_size += buf->b_ml.ml_chunksize[i].mlcs_totalsize;
+	}
+    }
+}
+
+/*
+ * Test ml_chunktree_find(), ml_chunktree_add() and ml_chunktree_append().
+ */
+    static void
+test_ml_chunktree(void)
+{
+    buf_T	buf;
+    chunksize_T	*cp;
+    int		i;
+    int		idx;
+    int		numlines;
+    long	size;
+
+    vim_memset(&buf, 0, sizeof(buf));
+    buf.b_ml.ml_numchunks = MAX_CHUNKS + 1;
+    buf.b_ml.ml_chunksize = ALLOC_CLEAR_MULT(chunksize_T, MAX_CHUNKS + 1);
+    assert(buf.b_ml.ml_chunksize != NULL);
+    cp = buf.b_ml.ml_chunksize;
+
+    /* A single chunk: always found. */
+    buf.b_ml.ml_usedchunks = 1;
+    cp[0].mlcs_numlines = 3;
+    cp[0].mlcs_totalsize = 30;
+    check_chunktree(&buf);
+    assert(buf.b_ml.ml_chunktree_ok);
+
+    /* Appending chunks keeps the tree valid. */
+    srand(1234);
+    while (buf.b_ml.ml_usedchunks < 300)
+    {
+	cp[buf.b_ml.ml_usedchunks].mlcs_numlines = rand() % 10;
+	cp[buf.b_ml.ml_usedchunks].mlcs_totalsize = rand() % 100;
+	++buf.b_ml.ml_usedchunks;
+	ml_chunktree_append(&buf);
+	assert(buf.b_ml.ml_chunktree_ok);
+    }
+    check_chunktree(&buf);
+
+    /* Changing chunks keeps the tree valid. */
+    for (i = 0; i < TEST_COUNT; ++i)
+    {
+	idx = rand() % buf.b_ml.ml_usedchunks;
+	numlines = rand() % 3 - 1;
+	size = rand() % 41 - 20;
+	if (cp[idx].mlcs_numlines + numlines < 0)
+	    numlines = 0;
+	if (cp[idx].mlcs_totalsize + size < 0)
+	    size = 0;
+	cp[idx].mlcs_numlines += numlines;
+	cp[idx].mlcs_totalsize += size;
+	ml_chunktree_add(&buf, idx, numlines, size);
+	if (i % 1000 == 0)
+	    check_chunktree(&buf);
+    }
+    check_chunktree(&buf);
+
+    /* After the chunks were rearranged the tree is built again. */
+    buf.b_ml.ml_usedchunks = MAX_CHUNKS;
+    for (i = 0; i < MAX_CHUNKS; ++i)
+    {
+	cp[i].mlcs_numlines = 400 + rand() % 400;
+	cp[i].mlcs_totalsize = cp[i].mlcs_numlines * (rand() % 80);
+    }
+    buf.b_ml.ml_chunktree_ok = FALSE;
+    check_chunktree(&buf);
+
+    vim_free(buf.b_ml.ml_chunksize);
+    vim_free(buf.b_ml.ml_chunktree);
+}
+
+    int
+main(void)
+{
+    test_ml_chunktree();
+    return 0;
+}
@@ -1110,6 +1110,7 @@ free_all_mem(void)
     /* Obviously named calls. */
     free_all_autocmds();
     clear_termcodes();
+    free_out_buf();
     free_all_marks();
     alist_clear(&global_alist);
     free_homedir();
@@ -1243,6 +1244,9 @@ free_all_mem(void)
 
     /* screenlines (can't display anything now!) */
     free_screenlines();
+# ifdef FEAT_STL_OPT
+    stl_cache_free(NULL);
+# endif
 
 # if defined(FEAT_SOUND)
     sound_free();
@@ -3935,6 +3935,28 @@ do_put(
 		    i = 1;
 		}
 
+		if (!(flags & PUT_FIXINDENT) && i < y_size)
+		{
+		    long    n = y_size - i - (y_type == MCHAR ? 1 : 0);
+		    long    done = 0;
+
+		    // Append the lines in one go.  For MCHAR the last line was
+		    // already inserted above.
+		    if (n > 0)
+			done = ml_append_lines(curbuf, lnum, y_array + i, n,
+									FALSE);
+		    lnum += done;
+		    nr_lines += done;
+		    if (done < n)
+			goto error;
+		    if (y_type == MCHAR)
+		    {
+			++lnum;
+			++nr_lines;
+		    }
+		    i = y_size;
+		}
+
 		for (; i < y_size; ++i)
 		{
 		    if ((y_type != MCHAR || i < y_size - 1)
@@ -6117,7 +6117,7 @@ set_num_option(
 	errmsg = e_invarg;
 	p_hi = 10000;
     }
-    if (p_re < 0 || p_re > 2)
+    if (p_re < 0 || p_re > 3)
     {
 	errmsg = e_invarg;
 	p_re = 0;
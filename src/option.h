@@ -287,6 +287,15 @@
 #define STL_TABCLOSENR	'X'		// tab page close nr
 #define STL_ALL		((char_u *) "fFtcvVlLknoObBrRhHmYyWwMqpPaN{#")
 
+// flags for the cache hint of a "%{=flags:expr}" item, see 'statuslinecache'
+#define STL_HINT_ON	0x01		// item has a cache hint
+#define STL_HINT_BUF	0x02		// 'b': buffer and b:changedtick
+#define STL_HINT_FILE	0x04		// 'f': file name, 'modified', 'ro'
+#define STL_HINT_CURSOR	0x08		// 'c': cursor position and topline
+#define STL_HINT_MODE	0x10		// 'm': State
+#define STL_HINT_WIN	0x20		// 'w': window size, current window
+#define STL_HINT_ALL	0x3f
+
 // flags used for parsed 'wildmode'
 #define WIM_FULL	0x01
 #define WIM_LONGEST	0x02
@@ -417,6 +426,7 @@ EXTERN int	p_confirm;	// 'confirm'
 #endif
 EXTERN int	p_cp;		// 'compatible'
 EXTERN char_u	*p_cot;		// 'completeopt'
+EXTERN int	p_chi;		// 'compresshidden'
 #ifdef BACKSLASH_IN_FILENAME
 EXTERN char_u	*p_csl;		// 'completeslash'
 #endif
@@ -774,6 +784,7 @@ EXTERN int	p_ssl;		// 'shellslash'
 #endif
 #ifdef FEAT_STL_OPT
 EXTERN char_u	*p_stl;		// 'statusline'
+EXTERN int	p_slc;		// 'statuslinecache'
 #endif
 EXTERN int	p_sr;		// 'shiftround'
 EXTERN char_u	*p_shm;		// 'shortmess'
@@ -814,6 +814,9 @@ static struct vimoption options[] =
 			    (char_u *)&p_cpt, PV_CPT,
 			    {(char_u *)".,w,b,u,t,i", (char_u *)0L}
 			    SCTX_INIT},
+    {"compresshidden", "chi", P_BOOL|P_VI_DEF,
+			    (char_u *)&p_chi, PV_NONE,
+			    {(char_u *)FALSE, (char_u *)0L} SCTX_INIT},
     {"concealcursor","cocu", P_STRING|P_ALLOCED|P_RWIN|P_VI_DEF,
 #ifdef FEAT_CONCEAL
 			    (char_u *)VAR_WIN, PV_COCU,
@@ -2563,6 +2566,13 @@ static struct vimoption options[] =
 			    (char_u *)NULL, PV_NONE,
 #endif
 			    {(char_u *)"", (char_u *)0L} SCTX_INIT},
+    {"statuslinecache","slc", P_BOOL|P_VI_DEF|P_RSTAT,
+#ifdef FEAT_STL_OPT
+			    (char_u *)&p_slc, PV_NONE,
+#else
+			    (char_u *)NULL, PV_NONE,
+#endif
+			    {(char_u *)FALSE, (char_u *)0L} SCTX_INIT},
     {"suffixes",    "su",   P_STRING|P_VI_DEF|P_ONECOMMA|P_NODUP,
 			    (char_u *)&p_su, PV_NONE,
 			    {(char_u *)".bak,~,.o,.h,.info,.swp,.obj",
@@ -3078,6 +3088,7 @@ static struct vimoption options[] =
     p_term("t_bc", T_BC)
     p_term("t_BE", T_BE)
     p_term("t_BD", T_BD)
+    p_term("t_BS", T_BSU)
     p_term("t_cd", T_CD)
     p_term("t_ce", T_CE)
     p_term("t_cl", T_CL)
@@ -3094,6 +3105,7 @@ static struct vimoption options[] =
     p_term("t_dl", T_DL)
     p_term("t_EC", T_CEC)
     p_term("t_EI", T_CEI)
+    p_term("t_ES", T_ESU)
     p_term("t_fs", T_FS)
     p_term("t_GP", T_CGP)
     p_term("t_IE", T_CIE)
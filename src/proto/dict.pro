@@ -17,6 +17,7 @@ int dict_add_number(dict_T *d, char *key, varnumber_T nr);
 int dict_add_special(dict_T *d, char *key, varnumber_T nr);
 int dict_add_string(dict_T *d, char *key, char_u *str);
 int dict_add_string_len(dict_T *d, char *key, char_u *str, int len);
+int dict_add_float(dict_T *d, char *key, float_T f);
 int dict_add_list(dict_T *d, char *key, list_T *list);
 int dict_add_callback(dict_T *d, char *key, callback_T *cb);
 void dict_iterate_start(typval_T *var, dict_iterator_T *iter);
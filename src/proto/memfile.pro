@@ -10,6 +10,8 @@ void mf_put(memfile_T *mfp, bhdr_T *hp, int dirty, int infile);
 void mf_free(memfile_T *mfp, bhdr_T *hp);
 int mf_sync(memfile_T *mfp, int flags);
 void mf_set_dirty(memfile_T *mfp);
+int mf_compress(memfile_T *mfp, int flags);
+void f_memfile_stats(typval_T *argvars, typval_T *rettv);
 int mf_release_all(void);
 blocknr_T mf_trans_del(memfile_T *mfp, blocknr_T old_nr);
 void mf_set_ffname(memfile_T *mfp);
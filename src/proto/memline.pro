@@ -16,6 +16,7 @@ void get_b0_dict(char_u *fname, dict_T *d);
 struct tm *vim_localtime(const time_t *timep, struct tm *result);
 char *get_ctime(time_t thetime, int add_newline);
 void ml_sync_all(int check_file, int check_char);
+void ml_compress_hidden(void);
 void ml_preserve(buf_T *buf, int message);
 char_u *ml_get(linenr_T lnum);
 char_u *ml_get_pos(pos_T *pos);
@@ -25,6 +26,7 @@ char_u *ml_get_buf(buf_T *buf, linenr_T lnum, int will_change);
 int ml_line_alloced(void);
 int ml_append(linenr_T lnum, char_u *line, colnr_T len, int newfile);
 int ml_append_buf(buf_T *buf, linenr_T lnum, char_u *line, colnr_T len, int newfile);
+long ml_append_lines(buf_T *buf, linenr_T lnum, char_u **lines, long count, int newfile);
 int ml_replace(linenr_T lnum, char_u *line, int copy);
 int ml_replace_len(linenr_T lnum, char_u *line_arg, colnr_T len_arg, int has_props, int copy);
 int ml_delete(linenr_T lnum, int message);
@@ -37,6 +39,7 @@ char_u *get_file_in_dir(char_u *fname, char_u *dname);
 void ml_setflags(buf_T *buf);
 char_u *ml_encrypt_data(memfile_T *mfp, char_u *data, off_T offset, unsigned size);
 void ml_decrypt_data(memfile_T *mfp, char_u *data, off_T offset, unsigned size);
+linenr_T ml_next_prop_line(buf_T *buf, linenr_T lnum);
 long ml_find_line_or_offset(buf_T *buf, linenr_T lnum, long *offp);
 void goto_byte(long cnt);
 /* vim: set ft=c : */
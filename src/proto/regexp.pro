@@ -1,5 +1,6 @@
 /* regexp.c */
 int re_multiline(regprog_T *prog);
+char_u *re_literal(regprog_T *prog, int ic);
 char_u *skip_regexp(char_u *startp, int dirc, int magic, char_u **newp);
 int vim_regcomp_had_eol(void);
 void free_regexp_stuff(void);
@@ -10,8 +11,10 @@ int vim_regsub(regmatch_T *rmp, char_u *source, typval_T *expr, char_u *dest, in
 int vim_regsub_multi(regmmatch_T *rmp, linenr_T lnum, char_u *source, char_u *dest, int copy, int magic, int backslash);
 char_u *reg_submatch(int no);
 list_T *reg_submatch_list(int no);
-regprog_T *vim_regcomp(char_u *expr_arg, int re_flags);
+regprog_T *vim_regcomp(char_u *expr, int re_flags);
 void vim_regfree(regprog_T *prog);
+int re_first_bytes(regprog_T *prog, int ic, char_u *set);
+void f_regexp_stats(typval_T *argvars, typval_T *rettv);
 int regprog_in_use(regprog_T *prog);
 int vim_regexec_prog(regprog_T **prog, int ignore_case, char_u *line, colnr_T col);
 int vim_regexec(regmatch_T *rmp, char_u *line, colnr_T col);
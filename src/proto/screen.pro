@@ -28,6 +28,9 @@ void win_redraw_last_status(frame_T *frp);
 void win_redr_status_matches(expand_T *xp, int num_matches, char_u **matches, int match, int showtail);
 int stl_connected(win_T *wp);
 int get_keymap_str(win_T *wp, char_u *fmt, char_u *buf, int len);
+void stl_cache_free(win_T *wp);
+char_u *stl_cache_item_get(win_T *wp, char_u *expr, int flags, int *idxp);
+void stl_cache_item_set(int idx, char_u *value);
 void screen_putchar(int c, int row, int col, int attr);
 void screen_getbytes(int row, int col, char_u *bytes, int *attrp);
 void screen_puts(char_u *text, int row, int col, int attr);
@@ -63,5 +66,8 @@ void comp_col(void);
 int number_width(win_T *wp);
 int screen_screencol(void);
 int screen_screenrow(void);
+void redraw_time_start(int phase);
+void redraw_time_end(int phase);
+void f_redraw_stats(typval_T *argvars, typval_T *rettv);
 char *set_chars_option(char_u **varp);
 /* vim: set ft=c : */
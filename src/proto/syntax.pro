@@ -3,6 +3,8 @@ void syn_set_timeout(proftime_T *tm);
 void syntax_start(win_T *wp, linenr_T lnum);
 void syn_stack_free_all(synblock_T *block);
 void syn_stack_apply_changes(buf_T *buf);
+int syntax_idle_pending(void);
+void syntax_idle_parse(long msec);
 void syntax_end_parsing(linenr_T lnum);
 int syntax_check_changed(linenr_T lnum);
 int get_syntax_attr(colnr_T col, int *can_spell, int keep_state);
@@ -22,4 +24,5 @@ int syn_get_stack_item(int i);
 int syn_get_foldlevel(win_T *wp, long lnum);
 void ex_syntime(exarg_T *eap);
 char_u *get_syntime_arg(expand_T *xp, int idx);
+void f_syntime_info(typval_T *argvars, typval_T *rettv);
 /* vim: set ft=c : */
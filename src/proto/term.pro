@@ -11,6 +11,11 @@ int term_is_gui(char_u *name);
 char_u *tltoa(unsigned long i);
 void termcapinit(char_u *name);
 void out_flush(void);
+void out_flush_collected(void);
+void out_redraw_start(void);
+void out_redraw_end(void);
+void out_add_stats(dict_T *d);
+void free_out_buf(void);
 void out_flush_cursor(int force, int clear_selection);
 void out_flush_check(void);
 void out_trash(void);
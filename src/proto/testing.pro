@@ -31,4 +31,5 @@ void f_test_null_string(typval_T *argvars, typval_T *rettv);
 void f_test_scrollbar(typval_T *argvars, typval_T *rettv);
 void f_test_setmouse(typval_T *argvars, typval_T *rettv);
 void f_test_settime(typval_T *argvars, typval_T *rettv);
+void f_test_syntax_idle_parse(typval_T *argvars, typval_T *rettv);
 /* vim: set ft=c : */
@@ -394,6 +394,35 @@ re_multiline(regprog_T *prog)
     return (prog->regflags & RF_HASNL);
 }
 
+/*
+ * When compiled regular expression "prog" only matches a fixed text, return
+ * that text in allocated memory.  "ic" is TRUE when 'ignorecase' applies.
+ * Returns NULL when the pattern uses any magic, is anchored, ignores case or
+ * combining characters, or was not compiled with the NFA engine.
+ */
+    char_u *
+re_literal(regprog_T *prog, int ic)
+{
+    nfa_regprog_T   *nprog = (nfa_regprog_T *)prog;
+    char_u	    buf[MB_MAXBYTES + 1];
+    int		    len;
+
+    if (prog->engine != &nfa_regengine || nprog->match_text == NULL
+	    || nprog->regstart == NUL || nprog->reganch
+	    || (prog->regflags & (RF_ICASE | RF_ICOMBINE))
+	    || (ic && !(prog->regflags & RF_NOICASE)))
+	return NULL;
+    if (has_mbyte)
+	len = (*mb_char2bytes)(nprog->regstart, buf);
+    else
+    {
+	buf[0] = nprog->regstart;
+	len = 1;
+    }
+    buf[len] = NUL;
+    return concat_str(buf, nprog->match_text);
+}
+
 /*
  * Check for an equivalence class name "[=a=]".  "pp" points to the '['.
  * Returns a character representing the class. Zero means that no item was
@@ -1133,6 +1162,16 @@ typedef struct {
 static regexec_T	rex;
 static int		rex_in_use = FALSE;
 
+#if defined(FEAT_EVAL) && defined(FEAT_RELTIME)
+# define REGEXP_ADAPT
+
+// While a backtracking program is timed for the automatic engine it uses its
+// own time limit.  "rex_sample_failed" is set when that limit is passed or
+// the program fails otherwise.
+static proftime_T	*rex_sample_tm = NULL;
+static int		rex_sample_failed;
+#endif
+
 /*
  * Return TRUE if character 'c' is included in 'iskeyword' option for
  * "reg_buf" buffer.
@@ -1647,6 +1686,56 @@ cstrchr(char_u *s, int c)
     return NULL;
 }
 
+/*
+ * Find byte "c" or "c" ^ 0x20 in "s", the two cases of a letter.
+ * Uses memchr() for each case, which is a lot faster than checking every
+ * byte.  The search for the second case stops where the first case was found.
+ */
+    static char_u *
+strbyte_ic(char_u *s, int c)
+{
+    size_t	len = STRLEN(s);
+    char_u	*p;
+    char_u	*q;
+
+    p = (char_u *)memchr(s, c, len);
+    q = (char_u *)memchr(s, c ^ 0x20, p == NULL ? len : (size_t)(p - s));
+    return q != NULL ? q : p;
+}
+
+/*
+ * Find where character "c" is in "s", like cstrchr(), for skipping ahead to
+ * where a match must start.  This is where most time goes when searching
+ * long lines for a pattern that starts with a literal.
+ * An ASCII byte can't be part of a multi-byte character in UTF-8, thus when
+ * "c" is ASCII the bytes are checked without finding character boundaries.
+ */
+    static char_u *
+regstrchr(char_u *s, int c)
+{
+    int		cc;
+
+    if (c >= 0x80 ? has_mbyte : enc_dbcs != 0)
+	return cstrchr(s, c);
+    if (rex.reg_ic)
+    {
+	// Use the same case folding as cstrchr().
+	if (MB_ISUPPER(c))
+	    cc = MB_TOLOWER(c);
+	else if (MB_ISLOWER(c))
+	    cc = MB_TOUPPER(c);
+	else
+	    cc = c;
+	if (cc != c)
+	{
+	    if (cc == (c ^ 0x20))
+		return strbyte_ic(s, c);
+	    return cstrchr(s, c);
+	}
+    }
+    return (char_u *)strchr((char *)s, c);
+}
+
 /***************************************************************
  *		      regsub stuff			       *
  ***************************************************************/
@@ -2534,18 +2623,17 @@ static int regexp_engine = 0;
 static char_u regname[][30] = {
 		    "AUTOMATIC Regexp Engine",
 		    "BACKTRACKING Regexp Engine",
-		    "NFA Regexp Engine"
+		    "NFA Regexp Engine",
+		    "DFA Regexp Engine"
 			    };
 #endif
 
 /*
- * Compile a regular expression into internal code.
- * Returns the program in allocated memory.
- * Use vim_regfree() to free the memory.
- * Returns NULL for an error.
+ * Compile a regular expression into internal code, without using the cache.
+ * Returns the program in allocated memory, NULL for an error.
  */
-    regprog_T *
-vim_regcomp(char_u *expr_arg, int re_flags)
+    static regprog_T *
+regcomp_nocache(char_u *expr_arg, int re_flags)
 {
     regprog_T   *prog = NULL;
     char_u	*expr = expr_arg;
@@ -2560,7 +2648,8 @@ vim_regcomp(char_u *expr_arg, int re_flags)
 
 	if (newengine == AUTOMATIC_ENGINE
 	    || newengine == BACKTRACKING_ENGINE
-	    || newengine == NFA_ENGINE)
+	    || newengine == NFA_ENGINE
+	    || newengine == DFA_ENGINE)
 	{
 	    regexp_engine = expr[4] - '0';
 	    expr += 5;
@@ -2571,7 +2660,7 @@ vim_regcomp(char_u *expr_arg, int re_flags)
 	}
 	else
 	{
-	    emsg(_("E864: \\%#= can only be followed by 0, 1, or 2. The automatic engine will be used "));
+	    emsg(_("E864: \\%#= can only be followed by 0, 1, 2 or 3. The automatic engine will be used "));
 	    regexp_engine = AUTOMATIC_ENGINE;
 	}
     }
@@ -2631,25 +2720,518 @@ vim_regcomp(char_u *expr_arg, int re_flags)
 	 * out to be very slow when executing it. */
 	prog->re_engine = regexp_engine;
 	prog->re_flags  = re_flags;
+	prog->re_refcount = 1;
+	prog->re_exec_count = 0;
+	prog->re_adapt = NULL;
+
+	// The DFA is used with the automatic and the DFA engine, not when
+	// the NFA engine was asked for.
+	if (regexp_engine == NFA_ENGINE)
+	    ((nfa_regprog_T *)prog)->dfa_ok = FALSE;
+    }
+
+    return prog;
+}
+
+#ifdef REGEXP_ADAPT
+/*
+ * With the automatic engine a program that is executed often is timed with
+ * both engines.  Each timed execution runs the backtracking program and then
+ * the NFA program on the same text, so that the two are compared on the same
+ * input.  Matching a line often takes less than the resolution of the timer,
+ * thus timing continues until enough time was measured to tell the engines
+ * apart.  After that the faster one is used for it.  The NFA program is
+ * compiled first; when backtracking turns out to be faster it is used
+ * instead, through "re_adapt".
+ * Backtracking can take exponential time, the NFA engine is the default to
+ * avoid that.  Therefore the backtracking program only gets a short time for
+ * each execution, without giving messages.  When it takes longer or fails
+ * otherwise, e.g. for 'maxmempattern', it is not used for the pattern.
+ */
+# define REGADAPT_START	    16	// executions before timing starts
+# define REGADAPT_SAMPLES   16	// min nr of timed executions with both engines
+# define REGADAPT_MAX_SAMPLES 2000  // max nr of timed executions
+# define REGADAPT_MIN_USEC  2000.0  // min total time of timed executions
+# define REGADAPT_BT_MSEC   20	// time limit of a backtracking execution
+
+# define REGADAPT_SAMPLE    0	// timing both engines
+# define REGADAPT_NFA	    1	// decided to use the NFA program
+# define REGADAPT_BT	    2	// decided to use "ra_bt_prog"
+
+typedef struct regadapt_S
+{
+    int		ra_state;	// REGADAPT_SAMPLE, REGADAPT_NFA or REGADAPT_BT
+    regprog_T	*ra_bt_prog;	// program compiled for backtracking
+    int		ra_count;	// nr of timed executions with both engines
+    double	ra_time[2];	// total time of the timed executions: NFA,
+				// backtracking
+} regadapt_T;
+
+static long	regadapt_nfa_count = 0;	// nr of programs that stayed NFA
+static long	regadapt_bt_count = 0;	// nr of programs that switched
+static proftime_T regadapt_bt_limit;	// time limit for "rex_sample_tm"
+
+/*
+ * Free the engine choice of "prog".
+ */
+    static void
+regadapt_free(regprog_T *prog)
+{
+    if (prog->re_adapt != NULL)
+    {
+	vim_regfree(prog->re_adapt->ra_bt_prog);
+	VIM_CLEAR(prog->re_adapt);
+    }
+}
+
+/*
+ * Decide which engine to use for "prog" after timing it.  "bt_failed" is
+ * TRUE when the backtracking program can't be used.
+ */
+    static void
+regadapt_decide(regadapt_T *ra, int bt_failed)
+{
+    // Only switch when backtracking is clearly faster.
+    if (!bt_failed && ra->ra_time[1] * 5 < ra->ra_time[0] * 4)
+    {
+	ra->ra_state = REGADAPT_BT;
+	++regadapt_bt_count;
+    }
+    else
+    {
+	ra->ra_state = REGADAPT_NFA;
+	++regadapt_nfa_count;
+	vim_regfree(ra->ra_bt_prog);
+	ra->ra_bt_prog = NULL;
+    }
+}
+
+/*
+ * Called before executing "rmp->regprog", which was compiled for the
+ * automatic engine.  Sets "rmp->regprog" to the program to use instead,
+ * if any.  Returns the NFA program.  Sets "*timed" when the execution is to
+ * be timed, starting "tm"; the backtracking program is then executed first.
+ */
+    static regprog_T *
+regadapt_start(regprog_T **progp, proftime_T *tm, int *timed)
+{
+    regprog_T	*prog = *progp;
+    regadapt_T	*ra = prog->re_adapt;
+
+    *timed = FALSE;
+    if (ra == NULL)
+    {
+	int	    save_p_re = p_re;
+	int	    save_called_emsg = called_emsg;
+# ifdef FEAT_SYN_HL
+	int	    save_extmatch = reg_do_extmatch;
+# endif
+
+	if (++prog->re_exec_count < REGADAPT_START)
+	    return prog;
+	ra = ALLOC_CLEAR_ONE(regadapt_T);
+	if (ra == NULL)
+	    return prog;
+	prog->re_adapt = ra;
+
+	// Checking for \z misuse was already done when compiling for NFA,
+	// allow all here.
+	p_re = BACKTRACKING_ENGINE;
+# ifdef FEAT_SYN_HL
+	reg_do_extmatch = REX_ALL;
+# endif
+	called_emsg = FALSE;
+	ra->ra_bt_prog = regcomp_nocache(((nfa_regprog_T *)prog)->pattern,
+							       prog->re_flags);
+	p_re = save_p_re;
+# ifdef FEAT_SYN_HL
+	reg_do_extmatch = save_extmatch;
+# endif
+	if (ra->ra_bt_prog == NULL || called_emsg)
+	{
+	    vim_regfree(ra->ra_bt_prog);
+	    ra->ra_bt_prog = NULL;
+	    ra->ra_state = REGADAPT_NFA;
+	}
+	called_emsg = save_called_emsg;
     }
 
+    if (ra->ra_state == REGADAPT_SAMPLE)
+    {
+	*progp = ra->ra_bt_prog;
+	*timed = TRUE;
+	profile_setlimit(REGADAPT_BT_MSEC, &regadapt_bt_limit);
+	rex_sample_tm = &regadapt_bt_limit;
+	rex_sample_failed = FALSE;
+	++emsg_off;
+	profile_start(tm);
+    }
+    else if (ra->ra_state == REGADAPT_BT)
+	*progp = ra->ra_bt_prog;
     return prog;
 }
 
 /*
- * Free a compiled regexp program, returned by vim_regcomp().
+ * Called after executing a program for the automatic engine.  "prog" is the
+ * NFA program that "*progp" is restored to.
+ * Returns TRUE when the backtracking program was timed, the NFA program must
+ * then be executed on the same text, it is timed as well.
+ */
+    static int
+regadapt_end(
+	regprog_T   **progp,
+	regprog_T   *prog,
+	proftime_T  *tm,
+	int	    timed)
+{
+    regadapt_T	*ra = prog->re_adapt;
+    int		bt = *progp != prog;
+
+    *progp = prog;
+    if (!timed || ra->ra_state != REGADAPT_SAMPLE)
+	return FALSE;
+
+    profile_end(tm);
+    if (bt)
+    {
+	rex_sample_tm = NULL;
+	--emsg_off;
+	if (rex_sample_failed)
+	{
+	    // Execute the NFA program without timing it.
+	    regadapt_decide(ra, TRUE);
+	    return TRUE;
+	}
+    }
+# ifdef MSWIN
+    {
+	LARGE_INTEGER	fr;
+
+	QueryPerformanceFrequency(&fr);
+	ra->ra_time[bt] += (double)tm->QuadPart * 1000000.0
+							  / (double)fr.QuadPart;
+    }
+# else
+    ra->ra_time[bt] += tm->tv_sec * 1000000.0 + tm->tv_usec;
+# endif
+    if (bt)
+    {
+	profile_start(tm);
+	return TRUE;
+    }
+    if (++ra->ra_count >= REGADAPT_SAMPLES
+	    && (ra->ra_time[0] + ra->ra_time[1] >= REGADAPT_MIN_USEC
+					|| ra->ra_count >= REGADAPT_MAX_SAMPLES))
+	regadapt_decide(ra, FALSE);
+    return FALSE;
+}
+#endif
+
+/*
+ * Cache of compiled regexp programs.  Plugins, syntax items and matches often
+ * use the same pattern over and over, with the cache it is compiled only
+ * once.  A program in the cache is shared, "re_refcount" counts the cache and
+ * every vim_regcomp() that returned it.  The least recently used entry that
+ * is not referenced elsewhere is replaced when the cache is full.
+ */
+#define REGCACHE_SIZE	32
+
+typedef struct
+{
+    char_u	*rc_pattern;	// pattern as passed to vim_regcomp()
+    hash_T	rc_hash;	// hash of "rc_pattern"
+    int		rc_flags;	// "re_flags" passed to vim_regcomp()
+    int		rc_state;	// regcache_state() when compiled
+    int		rc_had_eol;	// "had_eol" after compiling
+    regprog_T	*rc_prog;	// compiled program, NULL for an unused entry
+    long_u	rc_used;	// "regcache_tick" when last used
+} regcache_T;
+
+static regcache_T   regcache[REGCACHE_SIZE];
+static long_u	    regcache_tick = 0;
+static long	    regcache_hits = 0;
+static long	    regcache_misses = 0;
+
+/*
+ * Return a number for the state outside of the pattern that changes how it
+ * is compiled: 'regexpengine', \z() being allowed, 'cpoptions' and the
+ * encoding.
+ */
+    static int
+regcache_state(void)
+{
+    int		state = (int)p_re;
+
+#ifdef FEAT_SYN_HL
+    state |= reg_do_extmatch << 4;
+#endif
+    if (vim_strchr(p_cpo, CPO_LITERAL) != NULL)
+	state |= 0x100;
+    if (vim_strchr(p_cpo, CPO_BACKSL) != NULL)
+	state |= 0x200;
+    if (has_mbyte)
+	state |= 0x400;
+    if (enc_utf8)
+	state |= 0x800;
+    if (enc_dbcs != 0)
+	state |= 0x1000;
+    return state;
+}
+
+/*
+ * Return TRUE when the program for "expr" may be cached.  Not when it
+ * contains "~", it uses the previous substitute string, or a character class
+ * that depends on an option such as 'iskeyword'.
+ */
+    static int
+regcache_cacheable(char_u *expr)
+{
+    return vim_strchr(expr, '~') == NULL
+	    && strstr((char *)expr, "[:keyword:]") == NULL
+	    && strstr((char *)expr, "[:ident:]") == NULL
+	    && strstr((char *)expr, "[:fname:]") == NULL
+	    && strstr((char *)expr, "[:print:]") == NULL;
+}
+
+/*
+ * Find the cache entry for "expr" compiled with "re_flags" in "state".
+ * Returns NULL if there is none.
+ */
+    static regcache_T *
+regcache_find(char_u *expr, hash_T hash, int re_flags, int state)
+{
+    int		i;
+
+    for (i = 0; i < REGCACHE_SIZE; ++i)
+	if (regcache[i].rc_prog != NULL
+		&& regcache[i].rc_hash == hash
+		&& regcache[i].rc_flags == re_flags
+		&& regcache[i].rc_state == state
+		&& STRCMP(regcache[i].rc_pattern, expr) == 0)
+	    return &regcache[i];
+    return NULL;
+}
+
+/*
+ * Add "prog", compiled from "expr", to the cache.  Uses an empty entry or
+ * replaces the least recently used one that is not referenced elsewhere.
+ * When all entries are in use "prog" is not cached.
+ */
+    static void
+regcache_add(
+	char_u	    *expr,
+	hash_T	    hash,
+	int	    re_flags,
+	int	    state,
+	regprog_T   *prog)
+{
+    regcache_T	*rc = NULL;
+    char_u	*pat;
+    int		i;
+
+    for (i = 0; i < REGCACHE_SIZE; ++i)
+    {
+	if (regcache[i].rc_prog == NULL)
+	{
+	    rc = &regcache[i];
+	    break;
+	}
+	// A program that is being executed may only be referenced by the
+	// cache, after a recursive call replaced it with a copy.
+	if (regcache[i].rc_prog->re_refcount == 1
+		&& !regcache[i].rc_prog->re_in_use
+			  && (rc == NULL || regcache[i].rc_used < rc->rc_used))
+	    rc = &regcache[i];
+    }
+    if (rc == NULL)
+	return;
+    pat = vim_strsave(expr);
+    if (pat == NULL)
+	return;
+
+    if (rc->rc_prog != NULL)
+    {
+	vim_regfree(rc->rc_prog);
+	vim_free(rc->rc_pattern);
+    }
+    rc->rc_pattern = pat;
+    rc->rc_hash = hash;
+    rc->rc_flags = re_flags;
+    rc->rc_state = state;
+    rc->rc_had_eol = had_eol;
+    rc->rc_prog = prog;
+    rc->rc_used = ++regcache_tick;
+    ++prog->re_refcount;
+}
+
+/*
+ * "*progp" is being executed and is to be executed again recursively.  When
+ * it is shared through the cache, replace it with a copy of its own.
+ * Returns FAIL when that is not possible.
+ */
+    static int
+regcache_copy(regprog_T **progp)
+{
+    regcache_T	*rc = NULL;
+    regprog_T	*prog;
+    buf_T	*save_reg_buf = rex.reg_buf;
+#ifdef FEAT_SYN_HL
+    int		save_extmatch = reg_do_extmatch;
+#endif
+    int		i;
+
+    if ((*progp)->re_refcount <= 1)
+	return FAIL;
+    for (i = 0; i < REGCACHE_SIZE; ++i)
+	if (regcache[i].rc_prog == *progp)
+	    rc = &regcache[i];
+    // Options may have changed since the pattern was compiled.
+    if (rc == NULL || (rc->rc_state & ~0xf0) != (regcache_state() & ~0xf0))
+	return FAIL;
+
+#ifdef FEAT_SYN_HL
+    reg_do_extmatch = (rc->rc_state >> 4) & 0xf;
+#endif
+    prog = regcomp_nocache(rc->rc_pattern, rc->rc_flags);
+#ifdef FEAT_SYN_HL
+    reg_do_extmatch = save_extmatch;
+#endif
+    rex.reg_buf = save_reg_buf;
+    if (prog == NULL)
+	return FAIL;
+    vim_regfree(*progp);
+    *progp = prog;
+    return OK;
+}
+
+/*
+ * Compile a regular expression into internal code.
+ * Returns the program in allocated memory, which may be shared with other
+ * callers through the cache.  Use vim_regfree() to free it.
+ * Returns NULL for an error.
+ */
+    regprog_T *
+vim_regcomp(char_u *expr, int re_flags)
+{
+    regcache_T	*rc;
+    regprog_T	*prog;
+    hash_T	hash;
+    int		state;
+    int		save_called_emsg;
+
+    if (!regcache_cacheable(expr))
+	return regcomp_nocache(expr, re_flags);
+
+    state = regcache_state();
+    hash = hash_hash(expr);
+    rc = regcache_find(expr, hash, re_flags, state);
+    // A program that is being executed can't be shared, compile it again.
+    if (rc != NULL && !rc->rc_prog->re_in_use)
+    {
+	++regcache_hits;
+	rc->rc_used = ++regcache_tick;
+	had_eol = rc->rc_had_eol;
+	++rc->rc_prog->re_refcount;
+	return rc->rc_prog;
+    }
+
+    ++regcache_misses;
+    save_called_emsg = called_emsg;
+    called_emsg = FALSE;
+    prog = regcomp_nocache(expr, re_flags);
+    // Don't cache a program when there was an error or warning, it would
+    // not be given again.
+    if (prog != NULL && rc == NULL && !called_emsg)
+	regcache_add(expr, hash, re_flags, state, prog);
+    called_emsg |= save_called_emsg;
+    return prog;
+}
+
+/*
+ * Free a compiled regexp program, returned by vim_regcomp().  When it is
+ * shared through the cache only the reference count is decremented.
  */
     void
 vim_regfree(regprog_T *prog)
 {
-    if (prog != NULL)
+    if (prog != NULL && --prog->re_refcount <= 0)
+    {
+#ifdef REGEXP_ADAPT
+	regadapt_free(prog);
+#endif
 	prog->engine->regfree(prog);
+    }
+}
+
+/*
+ * Set the bits in "set" (32 bytes) for the bytes that a match of "prog" can
+ * start with, so that a caller can skip text that can't match without
+ * executing the program.  "ic" is TRUE when 'ignorecase' applies.  Bytes from
+ * 0x80 are always included.
+ * Returns FAIL when not known, "set" is then not valid.
+ */
+    int
+re_first_bytes(regprog_T *prog, int ic, char_u *set)
+{
+    if (prog->engine != &nfa_regengine)
+	return FAIL;
+    if (prog->regflags & RF_ICASE)
+	ic = TRUE;
+    else if (prog->regflags & RF_NOICASE)
+	ic = FALSE;
+    return nfa_first_bytes((nfa_regprog_T *)prog, ic, set);
 }
 
+#if defined(FEAT_EVAL) || defined(PROTO)
+/*
+ * "regexp_stats()" function
+ */
+    void
+f_regexp_stats(typval_T *argvars UNUSED, typval_T *rettv)
+{
+    dict_T	*d;
+    int		i;
+    int		entries = 0;
+
+    if (rettv_dict_alloc(rettv) != OK)
+	return;
+    for (i = 0; i < REGCACHE_SIZE; ++i)
+	if (regcache[i].rc_prog != NULL)
+	    ++entries;
+
+    d = rettv->vval.v_dict;
+    dict_add_number(d, "cache_hits", regcache_hits);
+    dict_add_number(d, "cache_misses", regcache_misses);
+    dict_add_number(d, "cache_entries", entries);
+    dict_add_number(d, "cache_size", REGCACHE_SIZE);
+    dict_add_number(d, "nfa_list_allocs", nfa_list_alloc_count);
+    dict_add_number(d, "nfa_list_reuses", nfa_list_reuse_count);
+#ifdef REGEXP_ADAPT
+    dict_add_number(d, "adapt_nfa", regadapt_nfa_count);
+    dict_add_number(d, "adapt_backtracking", regadapt_bt_count);
+#endif
+}
+#endif
+
 #if defined(EXITFREE) || defined(PROTO)
     void
 free_regexp_stuff(void)
 {
+    int		i;
+
+    for (i = 0; i < REGCACHE_SIZE; ++i)
+	if (regcache[i].rc_prog != NULL)
+	{
+	    vim_regfree(regcache[i].rc_prog);
+	    VIM_CLEAR(regcache[i].rc_pattern);
+	    regcache[i].rc_prog = NULL;
+	}
+    for (i = 0; i < NFA_LIST_KEEP_DEPTH; ++i)
+    {
+	VIM_CLEAR(nfa_list_keep[i].nk_t[0]);
+	VIM_CLEAR(nfa_list_keep[i].nk_t[1]);
+	VIM_CLEAR(nfa_list_keep[i].nk_listids);
+    }
     ga_clear(&regstack);
     ga_clear(&backpos);
     vim_free(reg_tofree);
@@ -2702,14 +3284,24 @@ vim_regexec_string(
     int		result;
     regexec_T	rex_save;
     int		rex_in_use_save = rex_in_use;
+    regprog_T	*prog_in_use;
+#ifdef REGEXP_ADAPT
+    regprog_T	*prog = NULL;
+    proftime_T	tm;
+    int		timed = FALSE;
+#endif
 
-    // Cannot use the same prog recursively, it contains state.
-    if (rmp->regprog->re_in_use)
+    // Cannot use the same prog recursively, it contains state.  When it is
+    // shared through the cache continue with a copy.
+    if (rmp->regprog->re_in_use && regcache_copy(&rmp->regprog) == FAIL)
     {
 	emsg(_(e_recursive));
 	return FALSE;
     }
-    rmp->regprog->re_in_use = TRUE;
+    // A recursive call may replace "rmp->regprog" with a copy, remember
+    // which program to reset "re_in_use" for.
+    prog_in_use = rmp->regprog;
+    prog_in_use->re_in_use = TRUE;
 
     if (rex_in_use)
 	// Being called recursively, save the state.
@@ -2721,8 +3313,16 @@ vim_regexec_string(
     rex.reg_startpos = NULL;
     rex.reg_endpos = NULL;
 
-    result = rmp->regprog->engine->regexec_nl(rmp, line, col, nl);
-    rmp->regprog->re_in_use = FALSE;
+#ifdef REGEXP_ADAPT
+    if (rmp->regprog->re_engine == AUTOMATIC_ENGINE)
+	prog = regadapt_start(&rmp->regprog, &tm, &timed);
+    do
+#endif
+	result = rmp->regprog->engine->regexec_nl(rmp, line, col, nl);
+#ifdef REGEXP_ADAPT
+    while (prog != NULL && regadapt_end(&rmp->regprog, prog, &tm, timed));
+#endif
+    prog_in_use->re_in_use = FALSE;
 
     /* NFA engine aborted because it's very slow. */
     if (rmp->regprog->re_engine == AUTOMATIC_ENGINE
@@ -2823,23 +3423,41 @@ vim_regexec_multi(
     int		result;
     regexec_T	rex_save;
     int		rex_in_use_save = rex_in_use;
+    regprog_T	*prog_in_use;
+#ifdef REGEXP_ADAPT
+    regprog_T	*prog = NULL;
+    proftime_T	adapt_tm;
+    int		timed = FALSE;
+#endif
 
-    // Cannot use the same prog recursively, it contains state.
-    if (rmp->regprog->re_in_use)
+    // Cannot use the same prog recursively, it contains state.  When it is
+    // shared through the cache continue with a copy.
+    if (rmp->regprog->re_in_use && regcache_copy(&rmp->regprog) == FAIL)
     {
 	emsg(_(e_recursive));
 	return FALSE;
     }
-    rmp->regprog->re_in_use = TRUE;
+    // A recursive call may replace "rmp->regprog" with a copy, remember
+    // which program to reset "re_in_use" for.
+    prog_in_use = rmp->regprog;
+    prog_in_use->re_in_use = TRUE;
 
     if (rex_in_use)
 	/* Being called recursively, save the state. */
 	rex_save = rex;
     rex_in_use = TRUE;
 
-    result = rmp->regprog->engine->regexec_multi(
+#ifdef REGEXP_ADAPT
+    if (rmp->regprog->re_engine == AUTOMATIC_ENGINE)
+	prog = regadapt_start(&rmp->regprog, &adapt_tm, &timed);
+    do
+#endif
+	result = rmp->regprog->engine->regexec_multi(
 				      rmp, win, buf, lnum, col, tm, timed_out);
-    rmp->regprog->re_in_use = FALSE;
+#ifdef REGEXP_ADAPT
+    while (prog != NULL && regadapt_end(&rmp->regprog, prog, &adapt_tm, timed));
+#endif
+    prog_in_use->re_in_use = FALSE;
 
     /* NFA engine aborted because it's very slow. */
     if (rmp->regprog->re_engine == AUTOMATIC_ENGINE
@@ -38,6 +38,7 @@
 #define	    AUTOMATIC_ENGINE	0
 #define	    BACKTRACKING_ENGINE	1
 #define	    NFA_ENGINE		2
+#define	    DFA_ENGINE		3
 
 typedef struct regengine regengine_T;
 
@@ -50,9 +51,13 @@ typedef struct regprog
 {
     regengine_T		*engine;
     unsigned		regflags;
-    unsigned		re_engine;   // automatic, backtracking or nfa engine
+    unsigned		re_engine;   // automatic, backtracking, nfa or dfa engine
     unsigned		re_flags;    // second argument for vim_regcomp()
     int			re_in_use;   // prog is being executed
+    int			re_refcount; // nr of references, see vim_regfree()
+    int			re_exec_count; // nr of times executed, for the
+				     // automatic engine
+    struct regadapt_S	*re_adapt;   // engine choice of automatic engine
 } regprog_T;
 
 /*
@@ -68,6 +73,9 @@ typedef struct
     unsigned		re_engine;
     unsigned		re_flags;
     int			re_in_use;
+    int			re_refcount;
+    int			re_exec_count;
+    struct regadapt_S	*re_adapt;
 
     int			regstart;
     char_u		reganch;
@@ -105,12 +113,17 @@ typedef struct
     unsigned		re_engine;
     unsigned		re_flags;
     int			re_in_use;
+    int			re_refcount;
+    int			re_exec_count;
+    struct regadapt_S	*re_adapt;
 
     nfa_state_T		*start;		/* points into state[] */
 
     int			reganch;	/* pattern starts with ^ */
     int			regstart;	/* char at start of pattern */
     char_u		*match_text;	/* plain text to match with */
+    int			dfa_ok;		/* can use a DFA to check for a match */
+    struct nfa_dfa_S	*dfa;		/* DFA states, NULL until used */
 
     int			has_zend;	/* pattern contains \ze */
     int			has_backref;	/* pattern contains \1 .. \9 */
@@ -0,0 +1,234 @@
+/* vi:set ts=8 sts=4 sw=4 noet:
+ *
+ * VIM - Vi IMproved	by Bram Moolenaar
+ *
+ * Do ":help uganda"  in Vim to read copying and usage conditions.
+ * Do ":help credits" in Vim to see a list of people who contributed.
+ * See README.txt for an overview of the Vim source code.
+ */
+
+/*
+ * regexp_bench.c: Benchmark for the regexp engines
+ *
+ * Run with "make bench_regexp".  A corpus of patterns, taken from syntax
+ * files, 'errorformat' and common searches, is matched against generated
+ * text that looks like C code, compiler output and log files.  Each pattern
+ * is run with the backtracking engine, the NFA engine, the NFA engine with
+ * the DFA and the automatic engine.  For each the throughput is reported,
+ * and a mismatch when an engine finds a different number of matches.  An
+ * optional argument sets the number of text lines, e.g. "./regexp_bench
+ * 100000".
+ */
+
+#include <stdio.h>
+
+/* Must include main.c because it contains much more than just main() */
+#define NO_VIM_MAIN
+#include "main.c"
+
+#define BENCH_LINE_LEN	200
+#define BENCH_RUNS	3	// nr of times the text is searched
+
+/*
+ * The corpus.
+ */
+static char *bench_patterns[] = {
+    // syntax/c.vim
+    "\\<\\(if\\|else\\|while\\|for\\|do\\|switch\\|return\\)\\>",
+    "\"\\([^\"\\\\]\\|\\\\.\\)*\"",
+    "/\\*.\\{-}\\*/",
+    "//.*$",
+    "^\\s*#\\s*\\(include\\|define\\|if\\|ifdef\\|endif\\)\\>",
+    "\\<\\d\\+\\(\\.\\d*\\)\\=\\([eE][-+]\\=\\d\\+\\)\\=[fl]\\=\\>",
+    "\\<0x\\x\\+\\>",
+    "\\<\\(char\\|int\\|long\\|void\\|static\\|const\\)\\>",
+    "\\<\\u\\w*_T\\>",
+    // 'errorformat' and compiler output
+    "^\\f\\+:\\d\\+:\\d\\+: \\(error\\|warning\\): .*$",
+    "^\\(\\f\\+\\)(\\(\\d\\+\\)) : \\(error\\|warning\\) C\\d\\+:",
+    "In function `\\w\\+':",
+    // log files
+    "\\<ERROR\\>",
+    "^\\d\\{4}-\\d\\d-\\d\\d \\d\\d:\\d\\d:\\d\\d \\(WARN\\|ERROR\\) ",
+    "connection\\d\\+.*timeout\\d\\+",
+    "\\cerror",
+    // common searches
+    "foobar",
+    "\\<handler\\>",
+    "\\s\\+$",
+    "\\<\\(\\w\\+\\)\\s\\+\\1\\>",
+    "[A-Z][a-z]\\+[A-Z]\\w*",
+    "\\%(alpha\\|beta\\|gamma\\|delta\\)\\d\\d\\d",
+    "\\v<(\\w+)\\(",
+    NULL
+};
+
+static char *bench_engines[] = {"1", "2", "3", "0"};
+static char *bench_engine_names[] = {"backtrack", "nfa", "dfa", "auto"};
+#define BENCH_ENGINES 4
+
+/*
+ * Return a random number from 0 to "n" - 1.
+ */
+    static int
+bench_random(int n)
+{
+    return rand() % n;
+}
+
+static char *bench_words[] = {
+    "alpha", "beta", "gamma", "delta", "value", "request", "handler",
+    "connection", "timeout", "status", "warning", "error", "buffer", "line"
+};
+#define BENCH_WORDS ((int)(sizeof(bench_words) / sizeof(char *)))
+
+/*
+ * Put the text for line "n" in "buf".
+ */
+    static void
+bench_line(char_u *buf, long n)
+{
+    char    *p = (char *)buf;
+    char    *end = p + BENCH_LINE_LEN - 40;
+    int	    i;
+
+    switch (bench_random(6))
+    {
+	case 0:	// log line
+	    p += sprintf(p, "2024-01-01 12:%02ld:%02ld %s ", n / 60 % 60,
+		    n % 60, bench_random(20) == 0 ? "ERROR"
+				     : bench_random(10) == 0 ? "WARN" : "INFO");
+	    for (i = 0; i < 12 && p < end; ++i)
+		p += sprintf(p, "%s%d ", bench_words[bench_random(BENCH_WORDS)],
+							     bench_random(1000));
+	    break;
+	case 1:	// compiler output
+	    p += sprintf(p, "src/%s.c:%d:%d: %s: %s undeclared",
+		    bench_words[bench_random(BENCH_WORDS)], bench_random(5000),
+		    bench_random(80), bench_random(3) == 0 ? "error" : "warning",
+				      bench_words[bench_random(BENCH_WORDS)]);
+	    break;
+	case 2:	// preprocessor
+	    p += sprintf(p, "#%s %s_%ld", bench_random(2) ? "define" : "ifdef",
+			       bench_words[bench_random(BENCH_WORDS)], n);
+	    break;
+	case 3:	// statement with a string and a comment
+	    p += sprintf(p, "    if (%s == 0x%lx) return \"%s \\\"%s\\\"\"; "
+		    "/* %s */", bench_words[bench_random(BENCH_WORDS)], n,
+		    bench_words[bench_random(BENCH_WORDS)],
+		    bench_words[bench_random(BENCH_WORDS)],
+		    bench_words[bench_random(BENCH_WORDS)]);
+	    break;
+	case 4:	// declaration
+	    p += sprintf(p, "static %s %sValue_T = %ld.%ldf; // %s %s  ",
+		    bench_random(2) ? "int" : "long",
+		    bench_words[bench_random(BENCH_WORDS)], n, n % 7,
+		    bench_words[bench_random(BENCH_WORDS)],
+		    bench_words[bench_random(BENCH_WORDS)]);
+	    break;
+	default: // prose
+	    for (i = 0; i < 15 && p < end; ++i)
+		p += sprintf(p, "%s ", bench_words[bench_random(BENCH_WORDS)]);
+	    break;
+    }
+}
+
+/*
+ * Match pattern "pat" with engine "engine" against all "count" lines in
+ * "lines", "runs" times.  Returns the number of matching lines and sets
+ * "secs".
+ */
+    static long
+bench_run(char *pat, char *engine, char_u **lines, long count, float_T *secs)
+{
+    char_u	buf[300];
+    regmatch_T	regmatch;
+    proftime_T	tm;
+    long	matches = 0;
+    long	i;
+    int		run;
+
+    vim_snprintf((char *)buf, sizeof(buf), "\\%%#=%s%s", engine, pat);
+    regmatch.regprog = vim_regcomp(buf, RE_MAGIC);
+    if (regmatch.regprog == NULL)
+	return -1;
+    regmatch.rm_ic = FALSE;
+
+    profile_start(&tm);
+    for (run = 0; run < BENCH_RUNS; ++run)
+	for (i = 0; i < count; ++i)
+	    if (vim_regexec(&regmatch, lines[i], 0))
+		++matches;
+    profile_end(&tm);
+    *secs = profile_float(&tm);
+
+    vim_regfree(regmatch.regprog);
+    return matches / BENCH_RUNS;
+}
+
+    int
+main(int argc, char **argv)
+{
+    long	count = 100000L;
+    char_u	**lines;
+    char_u	buf[BENCH_LINE_LEN];
+    long_u	bytes = 0;
+    long	i;
+    int		p;
+    int		e;
+    float_T	total[BENCH_ENGINES];
+
+    vim_memset(&params, 0, sizeof(params));
+    params.argc = argc;
+    params.argv = argv;
+    common_init(&params);
+    init_chartab();
+
+    if (argc > 1)
+	count = atol(argv[1]);
+    lines = ALLOC_MULT(char_u *, count);
+    if (lines == NULL)
+	return 1;
+    srand(1234);
+    for (i = 0; i < count; ++i)
+    {
+	bench_line(buf, i);
+	lines[i] = vim_strsave(buf);
+	if (lines[i] == NULL)
+	    return 1;
+	bytes += STRLEN(lines[i]) + 1;
+    }
+    printf("%ld lines, %lu Kbyte, searched %d times, Mbyte/sec:\n",
+					   count, bytes / 1024, BENCH_RUNS);
+    printf("%-10s %-10s %-10s %-10s %8s  pattern\n", bench_engine_names[0],
+	  bench_engine_names[1], bench_engine_names[2], bench_engine_names[3],
+								   "matches");
+
+    for (e = 0; e < BENCH_ENGINES; ++e)
+	total[e] = 0;
+    for (p = 0; bench_patterns[p] != NULL; ++p)
+    {
+	long	matches[BENCH_ENGINES];
+	int	mismatch = FALSE;
+
+	for (e = 0; e < BENCH_ENGINES; ++e)
+	{
+	    float_T secs = 0;
+
+	    matches[e] = bench_run(bench_patterns[p], bench_engines[e],
+							   lines, count, &secs);
+	    total[e] += secs;
+	    if (matches[e] != matches[0])
+		mismatch = TRUE;
+	    printf("%-10.1f ", secs > 0
+			  ? (float_T)bytes * BENCH_RUNS / secs / 1048576 : 0.0);
+	}
+	printf("%8ld  %s%s\n", matches[0], bench_patterns[p],
+					       mismatch ? "  MISMATCH" : "");
+    }
+    printf("total seconds:\n");
+    for (e = 0; e < BENCH_ENGINES; ++e)
+	printf("%-10.2f ", total[e]);
+    printf("\n");
+    return 0;
+}
@@ -2929,6 +2929,23 @@ do_class:
     return (int)count;
 }
 
+/*
+ * Give the error for exceeding 'maxmempattern'.  When timed for the automatic
+ * engine only remember the program failed, the NFA program is used instead.
+ */
+    static void
+reg_maxmempat_error(void)
+{
+#ifdef REGEXP_ADAPT
+    if (rex_sample_tm != NULL)
+    {
+	rex_sample_failed = TRUE;
+	return;
+    }
+#endif
+    emsg(_(e_maxmempat));
+}
+
 /*
  * Push an item onto the regstack.
  * Returns pointer to new item.  Returns NULL when out of memory.
@@ -2940,7 +2957,7 @@ regstack_push(regstate_T state, char_u *scan)
 
     if ((long)((unsigned)regstack.ga_len >> 10) >= p_mmp)
     {
-	emsg(_(e_maxmempat));
+	reg_maxmempat_error();
 	return NULL;
     }
     if (ga_grow(&regstack, sizeof(regitem_T)) == FAIL)
@@ -4002,7 +4019,7 @@ regmatch(
 		    // a regstar_T on the regstack.
 		    if ((long)((unsigned)regstack.ga_len >> 10) >= p_mmp)
 		    {
-			emsg(_(e_maxmempat));
+			reg_maxmempat_error();
 			status = RA_FAIL;
 		    }
 		    else if (ga_grow(&regstack, sizeof(regstar_T)) == FAIL)
@@ -4047,7 +4064,7 @@ regmatch(
 	    // Need a bit of room to store extra positions.
 	    if ((long)((unsigned)regstack.ga_len >> 10) >= p_mmp)
 	    {
-		emsg(_(e_maxmempat));
+		reg_maxmempat_error();
 		status = RA_FAIL;
 	    }
 	    else if (ga_grow(&regstack, sizeof(regbehind_T)) == FAIL)
@@ -4680,24 +4697,13 @@ bt_regexec_both(
 	    c = *prog->regmust;
 	s = line + col;
 
-	// This is used very often, esp. for ":global".  Use three versions of
-	// the loop to avoid overhead of conditions.
-	if (!rex.reg_ic && !has_mbyte)
-	    while ((s = vim_strbyte(s, c)) != NULL)
-	    {
-		if (cstrncmp(s, prog->regmust, &prog->regmlen) == 0)
-		    break;		// Found it.
-		++s;
-	    }
-	else if (!rex.reg_ic || (!enc_utf8 && mb_char2len(c) > 1))
-	    while ((s = vim_strchr(s, c)) != NULL)
-	    {
-		if (cstrncmp(s, prog->regmust, &prog->regmlen) == 0)
-		    break;		// Found it.
-		MB_PTR_ADV(s);
-	    }
+	// This is used very often, esp. for ":global".  When case matters
+	// strstr() can be used, finding it at a position that is not a
+	// character boundary only means regtry() is done for nothing.
+	if (!rex.reg_ic && !(enc_utf8 && rex.reg_icombine))
+	    s = (char_u *)strstr((char *)s, (char *)prog->regmust);
 	else
-	    while ((s = cstrchr(s, c)) != NULL)
+	    while ((s = regstrchr(s, c)) != NULL)
 	    {
 		if (cstrncmp(s, prog->regmust, &prog->regmlen) == 0)
 		    break;		// Found it.
@@ -4741,11 +4747,7 @@ bt_regexec_both(
 	    if (prog->regstart != NUL)
 	    {
 		// Skip until the char we know it must start with.
-		// Used often, do some work to avoid call overhead.
-		if (!rex.reg_ic && !has_mbyte)
-		    s = vim_strbyte(rex.line + col, prog->regstart);
-		else
-		    s = cstrchr(rex.line + col, prog->regstart);
+		s = regstrchr(rex.line + col, prog->regstart);
 		if (s == NULL)
 		{
 		    retval = 0;
@@ -4831,6 +4833,10 @@ bt_regexec_nl(
     rex.reg_icombine = FALSE;
     rex.reg_maxcol = 0;
 
+#ifdef REGEXP_ADAPT
+    if (rex_sample_tm != NULL)
+	return bt_regexec_both(line, col, rex_sample_tm, &rex_sample_failed);
+#endif
     return bt_regexec_both(line, col, NULL, NULL);
 }
 
@@ -4863,6 +4869,12 @@ bt_regexec_multi(
     rex.reg_icombine = FALSE;
     rex.reg_maxcol = rmp->rmm_maxcol;
 
+#ifdef REGEXP_ADAPT
+    // When timed for the automatic engine the caller's time limit is for the
+    // NFA program.
+    if (rex_sample_tm != NULL)
+	return bt_regexec_both(NULL, col, rex_sample_tm, &rex_sample_failed);
+#endif
     return bt_regexec_both(NULL, col, tm, timed_out);
 }
 
@@ -3846,6 +3846,29 @@ typedef struct
     int		    has_pim;	/* TRUE when any state has a PIM */
 } nfa_list_T;
 
+/*
+ * The thread lists and the "listids" array used by nfa_regmatch() are kept
+ * for the next call at the same recursion depth, instead of allocating and
+ * freeing them for every match attempt.  recursive_regmatch() calls
+ * nfa_regmatch() one level deeper, thus each depth has its own entry.
+ * Very big arrays are not kept, to avoid hanging on to lots of memory.
+ */
+#define NFA_LIST_KEEP_DEPTH	8	    // nr of recursion depths kept
+#define NFA_LIST_KEEP_MAX	(1024 * 1024) // max bytes for one kept array
+
+typedef struct
+{
+    nfa_thread_T    *nk_t[2];	    // thread arrays, or NULL
+    int		    nk_len[2];	    // nr of items in "nk_t"
+    int		    *nk_listids;    // listids array, or NULL
+    int		    nk_listids_len; // nr of items in "nk_listids"
+} nfa_list_keep_T;
+
+static nfa_list_keep_T nfa_list_keep[NFA_LIST_KEEP_DEPTH];
+static int	nfa_regmatch_depth = 0;
+static long	nfa_list_alloc_count = 0;   // nr of thread arrays allocated
+static long	nfa_list_reuse_count = 0;   // nr of thread arrays reused
+
 #ifdef ENABLE_LOG
 static void log_subexpr(regsub_T *sub);
 
@@ -5421,11 +5444,7 @@ skip_to_start(int c, colnr_T *colp)
 {
     char_u *s;
 
-    /* Used often, do some work to avoid call overhead. */
-    if (!rex.reg_ic && !has_mbyte)
-	s = vim_strbyte(rex.line + *colp, c);
-    else
-	s = cstrchr(rex.line + *colp, c);
+    s = regstrchr(rex.line + *colp, c);
     if (s == NULL)
 	return FAIL;
     *colp = (int)(s - rex.line);
@@ -5444,9 +5463,27 @@ find_match_text(colnr_T startcol, int regstart, char_u *match_text)
     int	    c1, c2;
     int	    len1, len2;
     int	    match;
+    char_u  *s;
+    // When case matters and "regstart" is a single byte the text can be
+    // found with strstr(), which is much faster than going over the
+    // characters.
+    int	    quick = !rex.reg_ic && *match_text != NUL
+		      && (regstart < 0x80 ? enc_dbcs == 0 : !has_mbyte);
 
     for (;;)
     {
+	if (quick)
+	{
+	    // Find "match_text" right after "regstart".
+	    s = rex.line + col + 1;
+	    while ((s = (char_u *)strstr((char *)s, (char *)match_text)) != NULL
+							 && s[-1] != regstart)
+		++s;
+	    if (s == NULL)
+		break;
+	    col = (colnr_T)(s - 1 - rex.line);
+	}
+
 	match = TRUE;
 	len2 = MB_CHAR2LEN(regstart); /* skip regstart */
 	for (len1 = 0; match_text[len1] != NUL; len1 += MB_CHAR2LEN(c1))
@@ -5540,6 +5577,8 @@ nfa_regmatch(
     int		add_off = 0;
     int		toplevel = start->c == NFA_MOPEN;
     regsubs_T	*r;
+    nfa_list_keep_T *keep;
+    int		i;
 #ifdef NFA_REGEXP_DEBUG_LOG
     FILE	*debug;
 #endif
@@ -5564,13 +5603,35 @@ nfa_regmatch(
 #endif
     nfa_match = FALSE;
 
-    /* Allocate memory for the lists of nodes. */
+    /* Get memory for the lists of nodes, reuse the lists of a previous call
+     * at this recursion depth when they are big enough. */
     size = (prog->nstate + 1) * sizeof(nfa_thread_T);
-
-    list[0].t = alloc(size);
-    list[0].len = prog->nstate + 1;
-    list[1].t = alloc(size);
-    list[1].len = prog->nstate + 1;
+    keep = nfa_regmatch_depth < NFA_LIST_KEEP_DEPTH
+			       ? &nfa_list_keep[nfa_regmatch_depth] : NULL;
+    ++nfa_regmatch_depth;
+    for (i = 0; i < 2; ++i)
+    {
+	if (keep != NULL && keep->nk_t[i] != NULL
+				      && keep->nk_len[i] >= prog->nstate + 1)
+	{
+	    list[i].t = keep->nk_t[i];
+	    list[i].len = keep->nk_len[i];
+	    keep->nk_t[i] = NULL;
+	    ++nfa_list_reuse_count;
+	}
+	else
+	{
+	    list[i].t = alloc(size);
+	    list[i].len = prog->nstate + 1;
+	    ++nfa_list_alloc_count;
+	}
+    }
+    if (keep != NULL && keep->nk_listids != NULL)
+    {
+	listids = keep->nk_listids;
+	listids_len = keep->nk_listids_len;
+	keep->nk_listids = NULL;
+    }
     if (list[0].t == NULL || list[1].t == NULL)
 	goto theend;
 
@@ -6954,10 +7015,41 @@ nextchar:
 #endif
 
 theend:
-    /* Free memory */
-    vim_free(list[0].t);
-    vim_free(list[1].t);
-    vim_free(listids);
+    /* Keep the lists for the next call, they may have grown.  Free them if
+     * they are too big or there is no place to keep them. */
+    --nfa_regmatch_depth;
+    for (i = 0; i < 2; ++i)
+    {
+	if (keep != NULL && list[i].t != NULL
+		&& (size_t)list[i].len * sizeof(nfa_thread_T)
+							<= NFA_LIST_KEEP_MAX)
+	{
+	    vim_free(keep->nk_t[i]);
+	    keep->nk_t[i] = list[i].t;
+	    keep->nk_len[i] = list[i].len;
+	}
+	else
+	    vim_free(list[i].t);
+    }
+    if (keep != NULL && listids != NULL
+	    && (size_t)listids_len * sizeof(int) <= NFA_LIST_KEEP_MAX)
+    {
+	vim_free(keep->nk_listids);
+	keep->nk_listids = listids;
+	keep->nk_listids_len = listids_len;
+    }
+    else
+	vim_free(listids);
+#ifdef ENABLE_LOG
+    log_fd = fopen(NFA_REGEXP_RUN_LOG, "a");
+    if (log_fd != NULL)
+    {
+	fprintf(log_fd, "Thread lists allocated: %ld, reused: %ld\n",
+				   nfa_list_alloc_count, nfa_list_reuse_count);
+	fclose(log_fd);
+    }
+    log_fd = NULL;
+#endif
 #undef ADD_STATE_IF_MATCH
 #ifdef NFA_REGEXP_DEBUG_LOG
     fclose(debug);
@@ -7105,6 +7197,626 @@ nfa_regtry(
     return 1 + rex.lnum;
 }
 
+/*
+ * Lazy DFA.
+ *
+ * When a pattern only uses characters, character classes, "^" and "$" the
+ * NFA can be simulated with a DFA: a DFA state stands for the set of NFA
+ * states that are active at a position.  DFA states are only made when they
+ * are reached and are then kept, thus after a few lines going over a line
+ * takes one table lookup per character.
+ * The DFA only finds out whether there is a match in the line, the NFA is
+ * then used to find where it is and the submatches.  Most lines don't match
+ * when searching, for ":g" and ":s", and those are done with the DFA only.
+ * Characters that have composing characters are left to the NFA.
+ */
+
+#define DFA_MAX_STATES	400	// flush the states when there are this many
+#define DFA_MAX_FLUSH	20	// stop using the DFA after this many flushes
+#define DFA_HASH_SIZE	512	// number of hash buckets, must be power of 2
+
+#define DFA_NOMATCH	0
+#define DFA_MATCH	1
+#define DFA_UNKNOWN	2	// DFA can't tell, need to use the NFA
+
+typedef struct
+{
+    int		*ds_ids;	// sorted indexes of the NFA states
+    int		ds_n;		// number of items in ds_ids
+    int		ds_hash_next;	// next state in the hash bucket or -1
+    int		ds_match;	// ds_ids contains NFA_MATCH
+    int		ds_eol_match;	// match at end of line, -1 when not known
+    short	ds_next[256];	// next state for a character, -1 if not known
+} dfa_state_T;
+
+typedef struct nfa_dfa_S nfa_dfa_T;
+struct nfa_dfa_S
+{
+    int		dfa_ic;		// value of rex.reg_ic used for the states
+    unsigned	dfa_cmp_flags;	// 'casemap' flags used for the states
+    int		dfa_flushes;	// number of times the states were flushed
+    int		dfa_start[2];	// start state, [1] for at start of line
+    int		dfa_count;	// number of states in dfa_states[]
+    dfa_state_T	*dfa_states[DFA_MAX_STATES];
+    int		dfa_hash[DFA_HASH_SIZE];
+    int		*dfa_set;	// NFA states of a new DFA state
+    int		*dfa_stack;	// stack used by dfa_closure()
+    int		*dfa_mark;	// NFA state was added when equal to dfa_markid
+    int		dfa_markid;
+};
+
+/*
+ * Return TRUE if NFA state "c" consumes a character and the DFA can handle
+ * it.  These are the classes that don't depend on options.
+ */
+    static int
+dfa_consumes(int c)
+{
+    switch (c)
+    {
+	case NFA_START_COLL:
+	case NFA_START_NEG_COLL:
+	case NFA_ANY:
+	case NFA_WHITE:
+	case NFA_NWHITE:
+	case NFA_DIGIT:
+	case NFA_NDIGIT:
+	case NFA_HEX:
+	case NFA_NHEX:
+	case NFA_OCTAL:
+	case NFA_NOCTAL:
+	case NFA_WORD:
+	case NFA_NWORD:
+	case NFA_HEAD:
+	case NFA_NHEAD:
+	case NFA_ALPHA:
+	case NFA_NALPHA:
+	case NFA_LOWER:
+	case NFA_NLOWER:
+	case NFA_UPPER:
+	case NFA_NUPPER:
+	case NFA_LOWER_IC:
+	case NFA_NLOWER_IC:
+	case NFA_UPPER_IC:
+	case NFA_NUPPER_IC:
+	    return TRUE;
+    }
+    return c > 0;
+}
+
+/*
+ * Return TRUE if the DFA can be used for "prog": all its states are
+ * characters, classes, "^", "$" or don't consume anything.
+ */
+    static int
+nfa_dfa_possible(nfa_regprog_T *prog)
+{
+    int	    i;
+    int	    c;
+
+    for (i = 0; i < prog->nstate; ++i)
+    {
+	c = prog->state[i].c;
+	if (dfa_consumes(c)
+		|| (c >= NFA_MOPEN && c <= NFA_MCLOSE9)
+#ifdef FEAT_SYN_HL
+		|| (c >= NFA_ZOPEN && c <= NFA_ZCLOSE9)
+#endif
+		|| (c >= NFA_CLASS_ALNUM && c <= NFA_CLASS_ESCAPE
+					 && c != NFA_CLASS_PRINT))  // 'isprint'
+	    continue;
+	switch (c)
+	{
+	    case NFA_SPLIT:
+	    case NFA_MATCH:
+	    case NFA_EMPTY:
+	    case NFA_END_COLL:
+	    case NFA_END_NEG_COLL:
+	    case NFA_RANGE_MIN:
+	    case NFA_RANGE_MAX:
+	    case NFA_BOL:
+	    case NFA_EOL:
+	    case NFA_ZSTART:
+	    case NFA_ZEND:
+	    case NFA_NOPEN:
+	    case NFA_NCLOSE:
+		break;
+	    default:
+		return FALSE;
+	}
+    }
+    return TRUE;
+}
+
+/*
+ * Return TRUE if character "c" matches NFA "state", for which dfa_consumes()
+ * is TRUE.  Must do the same as nfa_regmatch().
+ */
+    static int
+dfa_char_match(nfa_state_T *state, int c)
+{
+    switch (state->c)
+    {
+	case NFA_START_COLL:
+	case NFA_START_NEG_COLL:
+	  {
+	    nfa_state_T	*s = state->out;
+	    int		result_if_matched = (state->c == NFA_START_COLL);
+	    int		c1, c2;
+
+	    for ( ; s->c != NFA_END_COLL; s = s->out)
+	    {
+		if (s->c == NFA_RANGE_MIN)
+		{
+		    c1 = s->val;
+		    s = s->out;	    // advance to NFA_RANGE_MAX
+		    c2 = s->val;
+		    if (c >= c1 && c <= c2)
+			return result_if_matched;
+		    if (rex.reg_ic)
+		    {
+			int c_low = MB_TOLOWER(c);
+
+			for ( ; c1 <= c2; ++c1)
+			    if (MB_TOLOWER(c1) == c_low)
+				return result_if_matched;
+		    }
+		}
+		else if (s->c < 0 ? check_char_class(s->c, c)
+			: (c == s->c
+			    || (rex.reg_ic && MB_TOLOWER(c) == MB_TOLOWER(s->c))))
+		    return result_if_matched;
+	    }
+	    return !result_if_matched;
+	  }
+
+	case NFA_ANY:	    return TRUE;
+	case NFA_WHITE:	    return VIM_ISWHITE(c);
+	case NFA_NWHITE:    return !VIM_ISWHITE(c);
+	case NFA_DIGIT:	    return ri_digit(c);
+	case NFA_NDIGIT:    return !ri_digit(c);
+	case NFA_HEX:	    return ri_hex(c);
+	case NFA_NHEX:	    return !ri_hex(c);
+	case NFA_OCTAL:	    return ri_octal(c);
+	case NFA_NOCTAL:    return !ri_octal(c);
+	case NFA_WORD:	    return ri_word(c);
+	case NFA_NWORD:	    return !ri_word(c);
+	case NFA_HEAD:	    return ri_head(c);
+	case NFA_NHEAD:	    return !ri_head(c);
+	case NFA_ALPHA:	    return ri_alpha(c);
+	case NFA_NALPHA:    return !ri_alpha(c);
+	case NFA_LOWER:	    return ri_lower(c);
+	case NFA_NLOWER:    return !ri_lower(c);
+	case NFA_UPPER:	    return ri_upper(c);
+	case NFA_NUPPER:    return !ri_upper(c);
+	case NFA_LOWER_IC:  return ri_lower(c) || (rex.reg_ic && ri_upper(c));
+	case NFA_NLOWER_IC: return !(ri_lower(c) || (rex.reg_ic && ri_upper(c)));
+	case NFA_UPPER_IC:  return ri_upper(c) || (rex.reg_ic && ri_lower(c));
+	case NFA_NUPPER_IC: return !(ri_upper(c) || (rex.reg_ic && ri_lower(c)));
+    }
+    // regular character
+    return c == state->c
+		   || (rex.reg_ic && MB_TOLOWER(c) == MB_TOLOWER(state->c));
+}
+
+/*
+ * Set the bits in "set" (32 bytes) for the bytes that a match of "prog" can
+ * start with.  "ic" is TRUE when case is ignored.  Bytes from 0x80 are always
+ * included, only ASCII is checked.
+ * Returns FAIL when this can't be figured out, e.g. when the pattern can
+ * match an empty string or starts with a look-behind.
+ */
+    static int
+nfa_first_bytes(nfa_regprog_T *prog, int ic, char_u *set)
+{
+    char_u	*mark;
+    int		*stack;
+    int		sp = 0;
+    int		idx;
+    nfa_state_T	*s;
+    int		c;
+    int		save_reg_ic = rex.reg_ic;
+    int		result = OK;
+
+    mark = alloc_clear(prog->nstate);
+    stack = ALLOC_MULT(int, prog->nstate * 2 + 1);
+    if (mark == NULL || stack == NULL)
+    {
+	vim_free(mark);
+	vim_free(stack);
+	return FAIL;
+    }
+    vim_memset(set, 0, 16);
+    vim_memset(set + 16, 0xff, 16);
+    rex.reg_ic = ic;
+
+    stack[sp++] = (int)(prog->start - prog->state);
+    while (sp > 0 && result == OK)
+    {
+	idx = stack[--sp];
+	if (mark[idx])
+	    continue;
+	mark[idx] = TRUE;
+	s = &prog->state[idx];
+	if (dfa_consumes(s->c))
+	{
+	    for (c = 1; c < 0x80; ++c)
+		if (dfa_char_match(s, c))
+		    set[c >> 3] |= 1 << (c & 7);
+	    continue;
+	}
+	if ((s->c >= NFA_MOPEN && s->c <= NFA_MCLOSE9)
+#ifdef FEAT_SYN_HL
+		|| (s->c >= NFA_ZOPEN && s->c <= NFA_ZCLOSE9)
+#endif
+	   )
+	{
+	    stack[sp++] = (int)(s->out - prog->state);
+	    continue;
+	}
+	switch (s->c)
+	{
+	    case NFA_SPLIT:
+		stack[sp++] = (int)(s->out1 - prog->state);
+		stack[sp++] = (int)(s->out - prog->state);
+		break;
+	    // zero-width items that don't change where the match starts
+	    case NFA_EMPTY:
+	    case NFA_BOL:
+	    case NFA_BOF:
+	    case NFA_BOW:
+	    case NFA_EOW:
+	    case NFA_ZSTART:
+	    case NFA_ZEND:
+	    case NFA_NOPEN:
+	    case NFA_NCLOSE:
+		stack[sp++] = (int)(s->out - prog->state);
+		break;
+	    default:
+		// NFA_MATCH, NFA_EOL, newlines, look-behind, etc.
+		result = FAIL;
+		break;
+	}
+    }
+
+    rex.reg_ic = save_reg_ic;
+    vim_free(mark);
+    vim_free(stack);
+    return result;
+}
+
+/*
+ * Add NFA state "state" and the states that can be reached from it without
+ * consuming a character to dfa_set[*countp].  Only the states that consume
+ * a character, NFA_MATCH and NFA_EOL when not at the end of the line are
+ * added.  "bol" and "eol" are TRUE when "^" and "$" match here.
+ */
+    static void
+dfa_closure(
+    nfa_regprog_T   *prog,
+    nfa_state_T	    *state,
+    int		    bol,
+    int		    eol,
+    int		    *countp)
+{
+    nfa_dfa_T	*dfa = prog->dfa;
+    nfa_state_T	*s;
+    int		sp = 0;
+    int		idx;
+
+    dfa->dfa_stack[sp++] = (int)(state - prog->state);
+    while (sp > 0)
+    {
+	idx = dfa->dfa_stack[--sp];
+	if (dfa->dfa_mark[idx] == dfa->dfa_markid)
+	    continue;
+	dfa->dfa_mark[idx] = dfa->dfa_markid;
+	s = &prog->state[idx];
+	switch (s->c)
+	{
+	    case NFA_SPLIT:
+		dfa->dfa_stack[sp++] = (int)(s->out1 - prog->state);
+		dfa->dfa_stack[sp++] = (int)(s->out - prog->state);
+		break;
+	    case NFA_BOL:
+		if (bol)
+		    dfa->dfa_stack[sp++] = (int)(s->out - prog->state);
+		break;
+	    case NFA_EOL:
+		if (eol)
+		    dfa->dfa_stack[sp++] = (int)(s->out - prog->state);
+		else
+		    dfa->dfa_set[(*countp)++] = idx;
+		break;
+	    case NFA_MATCH:
+		dfa->dfa_set[(*countp)++] = idx;
+		break;
+	    default:
+		if (dfa_consumes(s->c))
+		    dfa->dfa_set[(*countp)++] = idx;
+		else
+		    dfa->dfa_stack[sp++] = (int)(s->out - prog->state);
+		break;
+	}
+    }
+}
+
+/*
+ * Remove all the DFA states.
+ */
+    static void
+dfa_flush(nfa_dfa_T *dfa)
+{
+    int	    i;
+
+    for (i = 0; i < dfa->dfa_count; ++i)
+	vim_free(dfa->dfa_states[i]);
+    dfa->dfa_count = 0;
+    for (i = 0; i < DFA_HASH_SIZE; ++i)
+	dfa->dfa_hash[i] = -1;
+    dfa->dfa_start[0] = -1;
+    dfa->dfa_start[1] = -1;
+}
+
+    static int
+dfa_compare_ids(const void *s1, const void *s2)
+{
+    return *(int *)s1 - *(int *)s2;
+}
+
+/*
+ * Return the index of the DFA state for the "count" NFA states in dfa_set[].
+ * Makes a new state when it doesn't exist yet.
+ * Returns -1 when out of memory or when giving up on the DFA.
+ */
+    static int
+dfa_add_state(nfa_regprog_T *prog, int count)
+{
+    nfa_dfa_T	*dfa = prog->dfa;
+    dfa_state_T	*ds;
+    long_u	hash = 0;
+    int		idx;
+    int		i;
+
+    qsort(dfa->dfa_set, (size_t)count, sizeof(int), dfa_compare_ids);
+    for (i = 0; i < count; ++i)
+	hash = hash * 31 + dfa->dfa_set[i];
+    hash &= DFA_HASH_SIZE - 1;
+    for (idx = dfa->dfa_hash[hash]; idx >= 0; idx = ds->ds_hash_next)
+    {
+	ds = dfa->dfa_states[idx];
+	if (ds->ds_n == count && memcmp(ds->ds_ids, dfa->dfa_set,
+						  count * sizeof(int)) == 0)
+	    return idx;
+    }
+
+    if (dfa->dfa_count == DFA_MAX_STATES)
+    {
+	// Too many states, the pattern is too complicated or the text too
+	// varied.  Start over, but not too often.
+	dfa_flush(dfa);
+	if (++dfa->dfa_flushes > DFA_MAX_FLUSH)
+	    return -1;
+    }
+
+    ds = alloc(sizeof(dfa_state_T) + count * sizeof(int));
+    if (ds == NULL)
+	return -1;
+    ds->ds_ids = (int *)(ds + 1);
+    mch_memmove(ds->ds_ids, dfa->dfa_set, count * sizeof(int));
+    ds->ds_n = count;
+    ds->ds_match = FALSE;
+    for (i = 0; i < count; ++i)
+	if (prog->state[ds->ds_ids[i]].c == NFA_MATCH)
+	    ds->ds_match = TRUE;
+    ds->ds_eol_match = -1;
+    for (i = 0; i < 256; ++i)
+	ds->ds_next[i] = -1;
+
+    idx = dfa->dfa_count++;
+    dfa->dfa_states[idx] = ds;
+    ds->ds_hash_next = dfa->dfa_hash[hash];
+    dfa->dfa_hash[hash] = idx;
+    return idx;
+}
+
+/*
+ * Return the index of the DFA state after DFA state "from" with character
+ * "c".  A new match may also start after "c".
+ * Returns -1 when out of memory or when giving up on the DFA.
+ */
+    static int
+dfa_next_state(nfa_regprog_T *prog, int from, int c)
+{
+    nfa_dfa_T	*dfa = prog->dfa;
+    dfa_state_T	*ds = dfa->dfa_states[from];
+    nfa_state_T	*s;
+    int		count = 0;
+    int		i;
+
+    ++dfa->dfa_markid;
+    for (i = 0; i < ds->ds_n; ++i)
+    {
+	s = &prog->state[ds->ds_ids[i]];
+	if (dfa_consumes(s->c) && dfa_char_match(s, c))
+	    // for a collection the next state is after NFA_END_COLL
+	    dfa_closure(prog, s->c == NFA_START_COLL
+		    || s->c == NFA_START_NEG_COLL ? s->out1->out : s->out,
+							FALSE, FALSE, &count);
+    }
+    dfa_closure(prog, prog->start, FALSE, FALSE, &count);
+    return dfa_add_state(prog, count);
+}
+
+/*
+ * Return TRUE if there is a match at the end of the line in DFA state "idx".
+ * "bol" is TRUE when this is also the start of the line.
+ */
+    static int
+dfa_eol_match(nfa_regprog_T *prog, int idx, int bol)
+{
+    nfa_dfa_T	*dfa = prog->dfa;
+    dfa_state_T	*ds = dfa->dfa_states[idx];
+    nfa_state_T	*s;
+    int		count = 0;
+    int		result = FALSE;
+    int		i;
+
+    if (ds->ds_eol_match >= 0 && !bol)
+	return ds->ds_eol_match;
+
+    ++dfa->dfa_markid;
+    for (i = 0; i < ds->ds_n; ++i)
+    {
+	s = &prog->state[ds->ds_ids[i]];
+	if (s->c == NFA_EOL)
+	    dfa_closure(prog, s->out, bol, TRUE, &count);
+    }
+    for (i = 0; i < count; ++i)
+	if (prog->state[dfa->dfa_set[i]].c == NFA_MATCH)
+	    result = TRUE;
+    if (!bol)
+	ds->ds_eol_match = result;
+    return result;
+}
+
+/*
+ * Allocate the DFA for "prog".  Returns FAIL when out of memory.
+ */
+    static int
+nfa_dfa_alloc(nfa_regprog_T *prog)
+{
+    nfa_dfa_T	*dfa;
+
+    dfa = ALLOC_CLEAR_ONE(nfa_dfa_T);
+    if (dfa == NULL)
+	return FAIL;
+    dfa->dfa_set = ALLOC_MULT(int, prog->nstate);
+    dfa->dfa_stack = ALLOC_MULT(int, prog->nstate * 2 + 1);
+    dfa->dfa_mark = ALLOC_CLEAR_MULT(int, prog->nstate);
+    if (dfa->dfa_set == NULL || dfa->dfa_stack == NULL
+						   || dfa->dfa_mark == NULL)
+    {
+	vim_free(dfa->dfa_set);
+	vim_free(dfa->dfa_stack);
+	vim_free(dfa->dfa_mark);
+	vim_free(dfa);
+	return FAIL;
+    }
+    dfa_flush(dfa);
+    dfa->dfa_ic = rex.reg_ic;
+    dfa->dfa_cmp_flags = cmp_flags;
+    prog->dfa = dfa;
+    return OK;
+}
+
+/*
+ * Free the DFA of "prog", if there is one.
+ */
+    static void
+nfa_dfa_free(nfa_regprog_T *prog)
+{
+    nfa_dfa_T	*dfa = prog->dfa;
+
+    if (dfa == NULL)
+	return;
+    dfa_flush(dfa);
+    vim_free(dfa->dfa_set);
+    vim_free(dfa->dfa_stack);
+    vim_free(dfa->dfa_mark);
+    vim_free(dfa);
+    prog->dfa = NULL;
+}
+
+/*
+ * Use the DFA of "prog" to find out if there is a match in "rex.line" that
+ * starts at or after column "col".
+ * Returns DFA_MATCH, DFA_NOMATCH or DFA_UNKNOWN.
+ */
+    static int
+nfa_dfa_exec(nfa_regprog_T *prog, colnr_T col)
+{
+    nfa_dfa_T	*dfa;
+    dfa_state_T	*ds;
+    char_u	*p = rex.line + col;
+    int		bol = (col == 0);
+    int		cur;
+    int		next;
+    int		c;
+    int		clen;
+    int		flushes;
+    int		count = 0;
+
+    if ((has_mbyte && !enc_utf8) || rex.reg_icombine || rex.reg_line_lbr)
+	return DFA_UNKNOWN;
+    if (prog->dfa == NULL && nfa_dfa_alloc(prog) == FAIL)
+	return DFA_UNKNOWN;
+    dfa = prog->dfa;
+    if (dfa->dfa_flushes > DFA_MAX_FLUSH)
+	return DFA_UNKNOWN;
+    // Ignoring case depends on 'casemap'.
+    if (dfa->dfa_ic != rex.reg_ic || dfa->dfa_cmp_flags != cmp_flags)
+    {
+	dfa_flush(dfa);
+	dfa->dfa_ic = rex.reg_ic;
+	dfa->dfa_cmp_flags = cmp_flags;
+    }
+
+    cur = dfa->dfa_start[bol];
+    if (cur < 0)
+    {
+	++dfa->dfa_markid;
+	dfa_closure(prog, prog->start, bol, FALSE, &count);
+	cur = dfa_add_state(prog, count);
+	if (cur < 0)
+	    return DFA_UNKNOWN;
+	dfa->dfa_start[bol] = cur;
+    }
+
+    for (;;)
+    {
+	ds = dfa->dfa_states[cur];
+	if (ds->ds_match)
+	    return DFA_MATCH;
+	if (ds->ds_n == 0)
+	    return DFA_NOMATCH;
+	if (*p == NUL)
+	    return dfa_eol_match(prog, cur, p == rex.line)
+						   ? DFA_MATCH : DFA_NOMATCH;
+
+	if (enc_utf8 && *p >= 0x80)
+	{
+	    c = utf_ptr2char(p);
+	    clen = utf_ptr2len(p);
+	    if (utf_iscomposing(c))
+		return DFA_UNKNOWN;
+	}
+	else
+	{
+	    c = *p;
+	    clen = 1;
+	}
+	// The NFA handles a character followed by a composing character
+	// in a special way.
+	if (enc_utf8 && p[clen] >= 0x80
+				 && utf_iscomposing(utf_ptr2char(p + clen)))
+	    return DFA_UNKNOWN;
+
+	next = c < 256 ? ds->ds_next[c] : -1;
+	if (next < 0)
+	{
+	    flushes = dfa->dfa_flushes;
+	    next = dfa_next_state(prog, cur, c);
+	    if (next < 0)
+		return DFA_UNKNOWN;
+	    if (c < 256 && flushes == dfa->dfa_flushes)
+		ds->ds_next[c] = next;
+	}
+	cur = next;
+	p += clen;
+    }
+}
+
 /*
  * Match a regexp against a string ("line" points to the string) or multiple
  * lines ("line" is NULL, use reg_getline()).
@@ -7201,6 +7913,10 @@ nfa_regexec_both(
     if (rex.reg_maxcol > 0 && col >= rex.reg_maxcol)
 	goto theend;
 
+    // When the DFA finds there is no match the NFA doesn't need to run.
+    if (prog->dfa_ok && nfa_dfa_exec(prog, col) == DFA_NOMATCH)
+	goto theend;
+
     // Set the "nstate" used by nfa_regcomp() to zero to trigger an error when
     // it's accidentally used during execution.
     nstate = 0;
@@ -7302,6 +8018,8 @@ nfa_regcomp(char_u *expr, int re_flags)
     prog->reganch = nfa_get_reganch(prog->start, 0);
     prog->regstart = nfa_get_regstart(prog->start, 0);
     prog->match_text = nfa_get_match_text(prog->start);
+    prog->dfa_ok = nfa_dfa_possible(prog);
+    prog->dfa = NULL;
 
 #ifdef ENABLE_LOG
     nfa_postfix_dump(expr, OK);
@@ -7341,6 +8059,7 @@ nfa_regfree(regprog_T *prog)
 {
     if (prog != NULL)
     {
+	nfa_dfa_free((nfa_regprog_T *)prog);
 	vim_free(((nfa_regprog_T *)prog)->match_text);
 	vim_free(((nfa_regprog_T *)prog)->pattern);
 	vim_free(prog);
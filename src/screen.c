@@ -36,6 +36,15 @@
  * The screen_*() functions write to the screen and handle updating
  * ScreenLines[].
  *
+ * win_line() does not write into ScreenLines[] directly, it builds one screen
+ * line in current_ScreenLine, the extra row after the screen.  screen_line()
+ * then compares it with what is on the screen and only outputs the cells that
+ * differ.  Windows are drawn one after another: while drawing a line the
+ * syntax state (in syntax.c), the cached line of the buffer (in memline.c)
+ * and expressions evaluated for 'foldexpr', 'foldtext' and the like all use
+ * global state, thus lines of different windows cannot be built at the same
+ * time.
+ *
  * update_screen() is the function that updates all windows and status lines.
  * It is called form the main loop when must_redraw is non-zero.  It may be
  * called from other places when an immediate screen update is needed.
@@ -117,7 +126,8 @@ static int compute_foldcolumn(win_T *wp, int col);
 static int redrawing_for_callback = 0;
 
 /*
- * Buffer for one screen line (characters and attributes).
+ * Buffer for one screen line (characters and attributes).  Points into the
+ * row after the last screen row, see screenalloc().
  */
 static schar_T	*current_ScreenLine;
 
@@ -161,6 +171,10 @@ static void win_redr_ruler(win_T *wp, int always, int ignore_pum);
 #ifdef FEAT_SYN_HL
 static void margin_columns_win(win_T *wp, int *left_col, int *right_col);
 #endif
+#ifdef FEAT_PROFILE
+static void redraw_time_new(void);
+static void redraw_time_log(void);
+#endif
 
 /* Ugly global: overrule attribute used by screen_char() */
 static int screen_char_attr = 0;
@@ -607,6 +621,14 @@ update_screen(int type_arg)
 	return FAIL;
     }
     updating_screen = TRUE;
+    out_redraw_start();
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+    {
+	redraw_time_new();
+	redraw_time_start(RDT_UPDATE_SCREEN);
+    }
+#endif
 
 #ifdef FEAT_TEXT_PROP
     // Update popup_mask if needed.  This may set w_redraw_top and w_redraw_bot
@@ -848,6 +870,14 @@ update_screen(int type_arg)
 	gui_update_scrollbars(FALSE);
     }
 #endif
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+    {
+	redraw_time_end(RDT_UPDATE_SCREEN);
+	redraw_time_log();
+    }
+#endif
+    out_redraw_end();
     return OK;
 }
 
@@ -1177,6 +1207,10 @@ win_update(win_T *wp)
     }
 #endif
 
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+	redraw_time_start(RDT_WIN_UPDATE);
+#endif
 #ifdef FEAT_SEARCH_EXTRA
     init_search_hl(wp, &search_hl);
 #endif
@@ -2358,6 +2392,10 @@ win_update(win_T *wp)
     if (!got_int)
 	got_int = save_got_int;
 #endif
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+	redraw_time_end(RDT_WIN_UPDATE);
+#endif
 }
 
 /*
@@ -3369,6 +3407,10 @@ win_line(
     if (startrow > endrow)		/* past the end already! */
 	return startrow;
 
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+	redraw_time_start(RDT_WIN_LINE);
+#endif
     row = startrow;
     screen_row = row + W_WINROW(wp);
 
@@ -3392,7 +3434,15 @@ win_line(
 	     * error, stop syntax highlighting. */
 	    save_did_emsg = did_emsg;
 	    did_emsg = FALSE;
+# ifdef FEAT_PROFILE
+	    if (redraw_time_on)
+		redraw_time_start(RDT_SYNTAX);
+# endif
 	    syntax_start(wp, lnum);
+# ifdef FEAT_PROFILE
+	    if (redraw_time_on)
+		redraw_time_end(RDT_SYNTAX);
+# endif
 	    if (did_emsg)
 		wp->w_s->b_syn_error = TRUE;
 	    else
@@ -3787,7 +3837,17 @@ win_line(
 # ifdef FEAT_SYN_HL
 	    /* Need to restart syntax highlighting for this line. */
 	    if (has_syntax)
+	    {
+#  ifdef FEAT_PROFILE
+		if (redraw_time_on)
+		    redraw_time_start(RDT_SYNTAX);
+#  endif
 		syntax_start(wp, lnum);
+#  ifdef FEAT_PROFILE
+		if (redraw_time_on)
+		    redraw_time_end(RDT_SYNTAX);
+#  endif
+	    }
 # endif
 	}
 #endif
@@ -3864,6 +3924,10 @@ win_line(
     {
 	char_u *prop_start;
 
+# ifdef FEAT_PROFILE
+	if (redraw_time_on)
+	    redraw_time_start(RDT_TEXTPROP);
+# endif
 	text_prop_count = get_text_props(wp->w_buffer, lnum,
 							   &prop_start, FALSE);
 	if (text_prop_count > 0)
@@ -3880,6 +3944,10 @@ win_line(
 	    area_highlighting = TRUE;
 	    extra_check = TRUE;
 	}
+# ifdef FEAT_PROFILE
+	if (redraw_time_on)
+	    redraw_time_end(RDT_TEXTPROP);
+# endif
     }
 #endif
 
@@ -4714,11 +4782,19 @@ win_line(
 		    save_did_emsg = did_emsg;
 		    did_emsg = FALSE;
 
+# ifdef FEAT_PROFILE
+		    if (redraw_time_on)
+			redraw_time_start(RDT_SYNTAX);
+# endif
 		    syntax_attr = get_syntax_attr((colnr_T)v - 1,
 # ifdef FEAT_SPELL
 						has_spell ? &can_spell :
 # endif
 						NULL, FALSE);
+# ifdef FEAT_PROFILE
+		    if (redraw_time_on)
+			redraw_time_end(RDT_SYNTAX);
+# endif
 
 		    if (did_emsg)
 		    {
@@ -6096,6 +6172,10 @@ win_line(
 #endif
 
     vim_free(p_extra_free);
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+	redraw_time_end(RDT_WIN_LINE);
+#endif
     return row;
 }
 
@@ -6176,6 +6256,45 @@ blocked_by_popup(int row, int col)
 }
 #endif
 
+/*
+ * Return the number of cells, at most "cols", starting at "off_from" and
+ * "off_to" that are equal in all the screen arrays.  Compares blocks of cells
+ * with memcmp(), which is a lot faster than calling char_needs_redraw() for
+ * each cell.  The result may be lower than the actual number of equal cells,
+ * since composing characters are compared also where they are not used.
+ */
+    static int
+screen_equal_cells(unsigned off_from, unsigned off_to, int cols)
+{
+    int	    done = 0;
+    int	    n;
+    int	    i;
+
+    while (done < cols)
+    {
+	n = cols - done > 32 ? 32 : cols - done;
+	if (memcmp(ScreenLines + off_from + done, ScreenLines + off_to + done,
+						      n * sizeof(schar_T)) != 0
+		|| memcmp(ScreenAttrs + off_from + done,
+			   ScreenAttrs + off_to + done, n * sizeof(sattr_T)) != 0)
+	    break;
+	if (enc_utf8)
+	{
+	    if (memcmp(ScreenLinesUC + off_from + done,
+			ScreenLinesUC + off_to + done, n * sizeof(u8char_T)) != 0)
+		break;
+	    for (i = 0; i < Screen_mco; ++i)
+		if (memcmp(ScreenLinesC[i] + off_from + done,
+		       ScreenLinesC[i] + off_to + done, n * sizeof(u8char_T)) != 0)
+		    break;
+	    if (i < Screen_mco)
+		break;
+	}
+	done += n;
+    }
+    return done;
+}
+
 /*
  * Move one "cooked" screen line to the screen, but only the characters that
  * have actually changed.  Handle insert/delete character.
@@ -6215,6 +6334,10 @@ screen_line(
 					/* 2: occupies two display cells */
 # define CHAR_CELLS char_cells
 
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+	redraw_time_start(RDT_SCREEN_LINE);
+#endif
     /* Check for illegal row and col, just in case. */
     if (row >= Rows)
 	row = Rows - 1;
@@ -6258,6 +6381,28 @@ screen_line(
 
     while (col < endcol)
     {
+	// Quickly skip over a run of unchanged cells.  The last one is handled
+	// below, the next character may need it to be redrawn.  Not for DBCS
+	// and 'weirdinvert', they need to look at every character.
+	if (!redraw_next && !force && enc_dbcs == 0 && !p_wiv
+							 && endcol - col > 2)
+	{
+	    int skip = screen_equal_cells(off_from, off_to, endcol - col) - 1;
+
+	    // Do not end up on the right half of a double-width character.
+	    if (enc_utf8 && skip > 0 && ScreenLines[off_from + skip] == 0)
+		--skip;
+	    if (skip > 0)
+	    {
+		off_from += skip;
+		off_to += skip;
+		col += skip;
+		// A double-width character may differ in its right half.
+		redraw_next = char_needs_redraw(off_from, off_to,
+								endcol - col);
+	    }
+	}
+
 	if (has_mbyte && (col + 1 < endcol))
 	    char_cells = (*mb_off2cells)(off_from, max_off_from);
 	else
@@ -6566,6 +6711,10 @@ screen_line(
 	else
 	    LineWraps[row] = FALSE;
     }
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+	redraw_time_end(RDT_SCREEN_LINE);
+#endif
 }
 
 #if defined(FEAT_RIGHTLEFT) || defined(PROTO)
@@ -6596,6 +6745,9 @@ status_redraw_all(void)
 {
     win_T	*wp;
 
+#ifdef FEAT_STL_OPT
+    ++stl_cache_tick;
+#endif
     FOR_ALL_WINDOWS(wp)
 	if (wp->w_status_height)
 	{
@@ -6612,6 +6764,9 @@ status_redraw_curbuf(void)
 {
     win_T	*wp;
 
+#ifdef FEAT_STL_OPT
+    ++stl_cache_tick;
+#endif
     FOR_ALL_WINDOWS(wp)
 	if (wp->w_status_height != 0 && wp->w_buffer == curbuf)
 	{
@@ -7212,6 +7367,340 @@ get_keymap_str(
 }
 
 #if defined(FEAT_STL_OPT) || defined(PROTO)
+/*
+ * Cache for 'tabline'.  The caches for 'statusline' and 'rulerformat' are in
+ * the window.
+ */
+static stlcache_T   *tal_cache = NULL;
+
+// Cache used for "%{=flags:expr}" items while building a status line, and
+// the index of the next item.
+static stlcache_T   *stl_cache_cur = NULL;
+static int	    stl_cache_item_idx = 0;
+
+/*
+ * Fill "key" with what a status line of window "wp" depends on, for the
+ * STL_HINT_ values in "flags".
+ */
+    static void
+stl_make_key(
+    win_T	*wp,
+    int		flags,
+    int		fillchar,
+    int		maxwidth,
+    stlkey_T	*key)
+{
+    buf_T	*buf = wp->w_buffer;
+
+    vim_memset(key, 0, sizeof(stlkey_T));
+    key->sk_tick = stl_cache_tick;
+    if (flags & (STL_HINT_BUF | STL_HINT_FILE))
+	key->sk_fnum = buf->b_fnum;
+    if (flags & STL_HINT_BUF)
+	key->sk_changedtick = CHANGEDTICK(buf);
+    if (flags & STL_HINT_FILE)
+    {
+	key->sk_changed = bufIsChanged(buf);
+	key->sk_readonly = buf->b_p_ro;
+    }
+    if (flags & STL_HINT_CURSOR)
+    {
+	key->sk_cursor = wp->w_cursor;
+	key->sk_topline = wp->w_topline;
+	key->sk_botline = wp->w_botline;
+    }
+    if (flags & STL_HINT_MODE)
+	key->sk_state = State;
+    if (flags & STL_HINT_WIN)
+    {
+	key->sk_width = wp->w_width;
+	key->sk_height = wp->w_height;
+	key->sk_curwin = wp == curwin;
+    }
+    key->sk_fillchar = fillchar;
+    key->sk_maxwidth = maxwidth;
+}
+
+/*
+ * Return TRUE when "key" and "fname" are what was stored for window "wp" with
+ * "newkey" and the file name.
+ */
+    static int
+stl_key_equal(
+    stlkey_T	*key,
+    char_u	*fname,
+    stlkey_T	*newkey,
+    win_T	*wp,
+    int		flags)
+{
+    char_u	*name = wp->w_buffer->b_fname;
+
+    if (memcmp(key, newkey, sizeof(stlkey_T)) != 0)
+	return FALSE;
+    if (flags & STL_HINT_FILE)
+    {
+	if (name == NULL || fname == NULL)
+	    return name == fname;
+	return STRCMP(name, fname) == 0;
+    }
+    return TRUE;
+}
+
+/*
+ * Return a copy of the file name of the buffer in window "wp" when "flags"
+ * includes STL_HINT_FILE, otherwise NULL.
+ */
+    static char_u *
+stl_key_fname(win_T *wp, int flags)
+{
+    if ((flags & STL_HINT_FILE) && wp->w_buffer->b_fname != NULL)
+	return vim_strsave(wp->w_buffer->b_fname);
+    return NULL;
+}
+
+/*
+ * Free the text of a cached status line.
+ */
+    static void
+stl_cache_clear_line(stlcache_T *cp)
+{
+    VIM_CLEAR(cp->sc_text);
+    VIM_CLEAR(cp->sc_fname);
+    VIM_CLEAR(cp->sc_hltab);
+    VIM_CLEAR(cp->sc_tabtab);
+}
+
+/*
+ * Free everything in status line cache "cp".
+ */
+    static void
+stl_cache_clear(stlcache_T *cp)
+{
+    int		i;
+    stlitem_T	*item;
+
+    stl_cache_clear_line(cp);
+    VIM_CLEAR(cp->sc_fmt);
+    for (i = 0; i < cp->sc_items.ga_len; ++i)
+    {
+	item = (stlitem_T *)cp->sc_items.ga_data + i;
+	vim_free(item->sti_expr);
+	vim_free(item->sti_fname);
+	vim_free(item->sti_value);
+    }
+    ga_clear(&cp->sc_items);
+}
+
+/*
+ * Free the cached status line and ruler of window "wp".  When "wp" is NULL
+ * free the cached tab pages line.
+ */
+    void
+stl_cache_free(win_T *wp)
+{
+    stlcache_T	**cpp[2];
+    int		i;
+
+    cpp[0] = wp == NULL ? &tal_cache : &wp->w_stl_cache;
+    cpp[1] = wp == NULL ? NULL : &wp->w_ruf_cache;
+    for (i = 0; i < 2; ++i)
+	if (cpp[i] != NULL && *cpp[i] != NULL)
+	{
+	    if (stl_cache_cur == *cpp[i])
+		stl_cache_cur = NULL;
+	    stl_cache_clear(*cpp[i]);
+	    VIM_CLEAR(*cpp[i]);
+	}
+}
+
+/*
+ * Get the cache for the status line of window "wp", its ruler when
+ * "draw_ruler" is TRUE or the tab pages line when "wp" is NULL.  The cache
+ * is cleared when it was used for another format than "fmt".
+ * Returns NULL when out of memory.
+ */
+    static stlcache_T *
+stl_cache_get(win_T *wp, int draw_ruler, char_u *fmt)
+{
+    stlcache_T	**cpp;
+    stlcache_T	*cp;
+
+    cpp = wp == NULL ? &tal_cache
+			  : draw_ruler ? &wp->w_ruf_cache : &wp->w_stl_cache;
+    if (*cpp == NULL)
+    {
+	*cpp = ALLOC_CLEAR_ONE(stlcache_T);
+	if (*cpp == NULL)
+	    return NULL;
+	ga_init2(&(*cpp)->sc_items, sizeof(stlitem_T), 4);
+    }
+    cp = *cpp;
+    if (cp->sc_fmt == NULL || STRCMP(cp->sc_fmt, fmt) != 0)
+    {
+	stl_cache_clear(cp);
+	cp->sc_fmt = vim_strsave(fmt);
+	if (cp->sc_fmt == NULL)
+	    return NULL;
+    }
+    return cp;
+}
+
+/*
+ * Copy the highlight records "from" to "to", changing the "start" pointers
+ * from text "from_text" to "to_text".
+ */
+    static void
+stl_copy_hlrec(
+    struct stl_hlrec	*to,
+    struct stl_hlrec	*from,
+    char_u		*from_text,
+    char_u		*to_text)
+{
+    int		n;
+
+    for (n = 0; from[n].start != NULL; ++n)
+    {
+	to[n].start = to_text + (from[n].start - from_text);
+	to[n].userhl = from[n].userhl;
+    }
+    to[n].start = NULL;
+    to[n].userhl = 0;
+}
+
+/*
+ * Return an allocated copy of the highlight records "tab" for the text that
+ * was in "text" and is now in "cached_text".
+ */
+    static struct stl_hlrec *
+stl_save_hlrec(struct stl_hlrec *tab, char_u *text, char_u *cached_text)
+{
+    struct stl_hlrec	*copy;
+    int			n;
+
+    for (n = 0; tab[n].start != NULL; ++n)
+	;
+    copy = ALLOC_MULT(struct stl_hlrec, n + 1);
+    if (copy != NULL)
+	stl_copy_hlrec(copy, tab, text, cached_text);
+    return copy;
+}
+
+/*
+ * When 'statuslinecache' is set and "cp" has a status line for "key" copy it
+ * to "buf", "hltab" and "tabtab" and return TRUE.
+ */
+    static int
+stl_cache_lookup(
+    stlcache_T		*cp,
+    win_T		*wp,
+    stlkey_T		*key,
+    char_u		*buf,
+    struct stl_hlrec	*hltab,
+    struct stl_hlrec	*tabtab)
+{
+    if (!p_slc || cp == NULL || cp->sc_text == NULL
+	    || !stl_key_equal(&cp->sc_key, cp->sc_fname, key, wp, STL_HINT_ALL))
+	return FALSE;
+    STRCPY(buf, cp->sc_text);
+    stl_copy_hlrec(hltab, cp->sc_hltab, cp->sc_text, buf);
+    stl_copy_hlrec(tabtab, cp->sc_tabtab, cp->sc_text, buf);
+    return TRUE;
+}
+
+/*
+ * When 'statuslinecache' is set store the status line in "buf", "hltab" and
+ * "tabtab", built for "key", in "cp".
+ */
+    static void
+stl_cache_store(
+    stlcache_T		*cp,
+    win_T		*wp,
+    stlkey_T		*key,
+    char_u		*buf,
+    struct stl_hlrec	*hltab,
+    struct stl_hlrec	*tabtab)
+{
+    if (!p_slc || cp == NULL)
+	return;
+    stl_cache_clear_line(cp);
+    cp->sc_text = vim_strsave(buf);
+    if (cp->sc_text == NULL)
+	return;
+    cp->sc_hltab = stl_save_hlrec(hltab, buf, cp->sc_text);
+    cp->sc_tabtab = stl_save_hlrec(tabtab, buf, cp->sc_text);
+    if (cp->sc_hltab == NULL || cp->sc_tabtab == NULL)
+    {
+	stl_cache_clear_line(cp);
+	return;
+    }
+    cp->sc_key = *key;
+    cp->sc_fname = stl_key_fname(wp, STL_HINT_ALL);
+}
+
+/*
+ * Called by build_stl_str_hl() for a "%{=flags:expr}" item of window "wp".
+ * Returns the cached result of "expr" in allocated memory, or NULL when it
+ * must be evaluated.  Then "*idxp" is to be passed to stl_cache_item_set().
+ */
+    char_u *
+stl_cache_item_get(win_T *wp, char_u *expr, int flags, int *idxp)
+{
+    garray_T	*gap;
+    stlitem_T	*item;
+    stlkey_T	key;
+
+    *idxp = -1;
+    if (stl_cache_cur == NULL)
+	return NULL;
+    gap = &stl_cache_cur->sc_items;
+    if (stl_cache_item_idx >= gap->ga_len)
+    {
+	if (ga_grow(gap, 1) == FAIL)
+	    return NULL;
+	item = (stlitem_T *)gap->ga_data + gap->ga_len++;
+	vim_memset(item, 0, sizeof(stlitem_T));
+    }
+    else
+	item = (stlitem_T *)gap->ga_data + stl_cache_item_idx;
+    *idxp = stl_cache_item_idx++;
+
+    stl_make_key(wp, flags, 0, 0, &key);
+    if (item->sti_value != NULL && STRCMP(item->sti_expr, expr) == 0
+		    && stl_key_equal(&item->sti_key, item->sti_fname,
+							   &key, wp, flags))
+	return vim_strsave(item->sti_value);
+
+    // Remember what the value will depend on, stl_cache_item_set() stores
+    // the value.
+    VIM_CLEAR(item->sti_value);
+    if (item->sti_expr == NULL || STRCMP(item->sti_expr, expr) != 0)
+    {
+	vim_free(item->sti_expr);
+	item->sti_expr = vim_strsave(expr);
+    }
+    item->sti_key = key;
+    vim_free(item->sti_fname);
+    item->sti_fname = stl_key_fname(wp, flags);
+    return NULL;
+}
+
+/*
+ * Store "value" as the result of the item "idx" that stl_cache_item_get()
+ * returned NULL for.
+ */
+    void
+stl_cache_item_set(int idx, char_u *value)
+{
+    stlitem_T	*item;
+
+    if (stl_cache_cur == NULL || idx < 0
+				      || idx >= stl_cache_cur->sc_items.ga_len)
+	return;
+    item = (stlitem_T *)stl_cache_cur->sc_items.ga_data + idx;
+    if (item->sti_expr != NULL)
+	item->sti_value = vim_strsave(value == NULL ? (char_u *)"" : value);
+}
+
 /*
  * Redraw the status line or ruler of window "wp".
  * When "wp" is NULL redraw the tab pages line from 'tabline'.
@@ -7239,6 +7728,8 @@ win_redr_custom(
     int		use_sandbox = FALSE;
     win_T	*ewp;
     int		p_crb_save;
+    stlcache_T	*cache;
+    stlkey_T	key;
 
     /* There is a tiny chance that this gets called recursively: When
      * redrawing a status line triggers redrawing the ruler or tabline.
@@ -7314,37 +7805,47 @@ win_redr_custom(
     if (maxwidth <= 0)
 	goto theend;
 
-    /* Temporarily reset 'cursorbind', we don't want a side effect from moving
-     * the cursor away and back. */
     ewp = wp == NULL ? curwin : wp;
-    p_crb_save = ewp->w_p_crb;
-    ewp->w_p_crb = FALSE;
+    cache = stl_cache_get(wp, draw_ruler, stl);
+    stl_make_key(ewp, STL_HINT_ALL, fillchar, maxwidth, &key);
+    if (!stl_cache_lookup(cache, ewp, &key, buf, hltab, tabtab))
+    {
+	/* Temporarily reset 'cursorbind', we don't want a side effect from
+	 * moving the cursor away and back. */
+	p_crb_save = ewp->w_p_crb;
+	ewp->w_p_crb = FALSE;
 
-    /* Make a copy, because the statusline may include a function call that
-     * might change the option value and free the memory. */
-    stl = vim_strsave(stl);
-    width = build_stl_str_hl(ewp, buf, sizeof(buf),
-				stl, use_sandbox,
-				fillchar, maxwidth, hltab, tabtab);
-    vim_free(stl);
-    ewp->w_p_crb = p_crb_save;
+	/* Make a copy, because the statusline may include a function call
+	 * that might change the option value and free the memory. */
+	stl = vim_strsave(stl);
+	stl_cache_cur = cache;
+	stl_cache_item_idx = 0;
+	width = build_stl_str_hl(ewp, buf, sizeof(buf),
+				    stl, use_sandbox,
+				    fillchar, maxwidth, hltab, tabtab);
+	stl_cache_cur = NULL;
+	vim_free(stl);
+	ewp->w_p_crb = p_crb_save;
 
-    /* Make all characters printable. */
-    p = transstr(buf);
-    if (p != NULL)
-    {
-	vim_strncpy(buf, p, sizeof(buf) - 1);
-	vim_free(p);
-    }
+	/* Make all characters printable. */
+	p = transstr(buf);
+	if (p != NULL)
+	{
+	    vim_strncpy(buf, p, sizeof(buf) - 1);
+	    vim_free(p);
+	}
 
-    /* fill up with "fillchar" */
-    len = (int)STRLEN(buf);
-    while (width < maxwidth && len < (int)sizeof(buf) - 1)
-    {
-	len += (*mb_char2bytes)(fillchar, buf + len);
-	++width;
+	/* fill up with "fillchar" */
+	len = (int)STRLEN(buf);
+	while (width < maxwidth && len < (int)sizeof(buf) - 1)
+	{
+	    len += (*mb_char2bytes)(fillchar, buf + len);
+	    ++width;
+	}
+	buf[len] = NUL;
+
+	stl_cache_store(cache, ewp, &key, buf, hltab, tabtab);
     }
-    buf[len] = NUL;
 
     /*
      * Draw each snippet with the specified highlighting.
@@ -8869,6 +9370,10 @@ screenclear2(void)
 	    )
 	return;
 
+#ifdef FEAT_STL_OPT
+    // Also evaluate cached status lines again.
+    ++stl_cache_tick;
+#endif
 #ifdef FEAT_GUI
     if (!gui.in_use)
 #endif
@@ -10331,6 +10836,11 @@ draw_tabline(void)
 
     if (ScreenLines == NULL)
 	return;
+#ifdef FEAT_STL_OPT
+    // Something changed that the tab pages line may show.
+    if (redraw_tabline && tal_cache != NULL)
+	stl_cache_clear_line(tal_cache);
+#endif
     redraw_tabline = FALSE;
 
 #ifdef FEAT_GUI_TABLINE
@@ -10986,6 +11496,175 @@ screen_screenrow(void)
 {
     return screen_cur_row;
 }
+
+#if defined(FEAT_PROFILE) || defined(PROTO)
+/*
+ * Timing of the redraw phases, see the RDT_ values.  The times are inclusive:
+ * the time of win_line() includes the syntax and screen_line() time.
+ */
+static char *rdt_names[RDT_COUNT] = {"update_screen", "win_update",
+		"win_line", "syntax", "textprop", "screen_line", "out_flush"};
+static int	  rdt_depth[RDT_COUNT];	    // nesting level of the phase
+static proftime_T rdt_start[RDT_COUNT];	    // when the phase was started
+static proftime_T rdt_total[RDT_COUNT];
+static long	  rdt_total_count[RDT_COUNT];
+static proftime_T rdt_last[RDT_COUNT];	    // for the last update_screen()
+static long	  rdt_last_count[RDT_COUNT];
+
+/*
+ * Start timing redraw phase "phase".  Must be followed by
+ * redraw_time_end(), only the outer call of a nested phase is timed.
+ */
+    void
+redraw_time_start(int phase)
+{
+    if (rdt_depth[phase]++ == 0)
+	profile_start(&rdt_start[phase]);
+}
+
+/*
+ * Stop timing redraw phase "phase" and add the time to the totals.
+ */
+    void
+redraw_time_end(int phase)
+{
+    if (rdt_depth[phase] == 0 || --rdt_depth[phase] > 0)
+	return;
+    profile_end(&rdt_start[phase]);
+    profile_add(&rdt_total[phase], &rdt_start[phase]);
+    profile_add(&rdt_last[phase], &rdt_start[phase]);
+    ++rdt_total_count[phase];
+    ++rdt_last_count[phase];
+}
+
+/*
+ * Called when update_screen() starts: clear the times of the last redraw.
+ */
+    static void
+redraw_time_new(void)
+{
+    int i;
+
+    for (i = 0; i < RDT_COUNT; ++i)
+    {
+	profile_zero(&rdt_last[i]);
+	rdt_last_count[i] = 0;
+    }
+}
+
+/*
+ * Clear all the redraw times.
+ */
+    static void
+redraw_time_clear(void)
+{
+    int i;
+
+    redraw_time_new();
+    for (i = 0; i < RDT_COUNT; ++i)
+    {
+	profile_zero(&rdt_total[i]);
+	rdt_total_count[i] = 0;
+	rdt_depth[i] = 0;
+    }
+}
+
+/*
+ * Called when update_screen() is done: write the times of the redraw to the
+ * channel log, if it's active.  Writing the output comes later, thus the
+ * "out_flush" time is what was written so far.
+ */
+    static void
+redraw_time_log(void)
+{
+# ifdef FEAT_JOB_CHANNEL
+    char_u  buf[400];
+    int	    len = 0;
+    int	    i;
+
+    if (!ch_log_active())
+	return;
+    for (i = 0; i < RDT_COUNT; ++i)
+	len += vim_snprintf((char *)buf + len, sizeof(buf) - len, " %s%s",
+				      rdt_names[i], profile_msg(&rdt_last[i]));
+    ch_log(NULL, "redraw:%s", buf);
+# endif
+}
+
+# ifdef FEAT_FLOAT
+/*
+ * Add the redraw times to dictionary "d" as the "time" item.
+ */
+    static void
+redraw_time_add_stats(dict_T *d)
+{
+    dict_T  *time_dict = dict_alloc();
+    dict_T  *phase_dict;
+    int	    i;
+
+    if (time_dict == NULL || dict_add_dict(d, "time", time_dict) == FAIL)
+    {
+	if (time_dict != NULL)
+	    dict_unref(time_dict);
+	return;
+    }
+    for (i = 0; i < RDT_COUNT; ++i)
+    {
+	phase_dict = dict_alloc();
+	if (phase_dict == NULL)
+	    return;
+	if (dict_add_dict(time_dict, rdt_names[i], phase_dict) == FAIL)
+	{
+	    dict_unref(phase_dict);
+	    return;
+	}
+	dict_add_float(phase_dict, "total", profile_float(&rdt_total[i]));
+	dict_add_number(phase_dict, "count", rdt_total_count[i]);
+	dict_add_float(phase_dict, "last", profile_float(&rdt_last[i]));
+	dict_add_number(phase_dict, "last_count", rdt_last_count[i]);
+    }
+}
+# endif
+#endif
+
+/*
+ * "redraw_stats()" function
+ */
+    void
+f_redraw_stats(typval_T *argvars, typval_T *rettv)
+{
+#ifdef FEAT_PROFILE
+    if (argvars[0].v_type != VAR_UNKNOWN)
+    {
+	char_u *what = tv_get_string_chk(&argvars[0]);
+
+	if (what == NULL)
+	    return;
+	if (STRCMP(what, "on") == 0)
+	{
+	    if (!redraw_time_on)
+		redraw_time_clear();
+	    redraw_time_on = TRUE;
+	}
+	else if (STRCMP(what, "off") == 0)
+	    redraw_time_on = FALSE;
+	else if (STRCMP(what, "clear") == 0)
+	    redraw_time_clear();
+	else
+	{
+	    semsg(_(e_invarg2), what);
+	    return;
+	}
+    }
+#endif
+    if (rettv_dict_alloc(rettv) != OK)
+	return;
+    out_add_stats(rettv->vval.v_dict);
+#if defined(FEAT_PROFILE) && defined(FEAT_FLOAT)
+    dict_add_number(rettv->vval.v_dict, "timing", redraw_time_on);
+    redraw_time_add_stats(rettv->vval.v_dict);
+#endif
+}
 #endif
 
 /*
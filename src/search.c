@@ -78,6 +78,33 @@ static char_u	    *mr_pattern = NULL;	/* pattern used by search_regcomp() */
 #ifdef FEAT_RIGHTLEFT
 static int	    mr_pattern_alloced = FALSE; /* mr_pattern was allocated */
 #endif
+static int	    mr_magic = TRUE;	/* 'magic' used by search_regcomp() */
+
+/*
+ * The matches of the last pattern in the last line searched backward in.
+ * Repeating a backward search in a long line can then find the match before
+ * the cursor without going over all the matches from the start of the line
+ * again.
+ */
+typedef struct
+{
+    colnr_T	sm_start;	// start column of the match
+    colnr_T	sm_end;		// end column of the match
+    int		sm_submatch;	// as returned by first_submatch()
+} searchmatch_T;
+
+static struct
+{
+    int		sc_fnum;	    // buffer number, zero when not valid
+    varnumber_T	sc_changedtick;	    // b:changedtick of the buffer
+    linenr_T	sc_lnum;	    // line number
+    char_u	*sc_pat;	    // pattern, allocated
+    int		sc_magic;	    // 'magic' used for "sc_pat"
+    int		sc_ic;		    // ignore case used for "sc_pat"
+    int		sc_cpo_search;	    // 'cpoptions' contains 'c'
+    int		sc_chartab_tick;    // value of chartab_tick
+    garray_T	sc_matches;	    // matches in the line, searchmatch_T
+} search_cache;
 
 #ifdef FEAT_FIND_ID
 /*
@@ -186,6 +213,7 @@ search_regcomp(
 
     regmatch->rmm_ic = ignorecase(pat);
     regmatch->rmm_maxcol = 0;
+    mr_magic = magic;
     regmatch->regprog = vim_regcomp(pat, magic ? RE_MAGIC : 0);
     if (regmatch->regprog == NULL)
 	return FAIL;
@@ -319,6 +347,8 @@ free_search_patterns(void)
 	mr_pattern = NULL;
     }
 # endif
+    vim_free(search_cache.sc_pat);
+    ga_clear(&search_cache.sc_matches);
 }
 #endif
 
@@ -573,6 +603,233 @@ last_pat_prog(regmmatch_T *regmatch)
 }
 #endif
 
+/*
+ * Return the text that "regmatch" matches when it only matches a literal
+ * text, in allocated memory.  When 'cpoptions' contains 'c' matches can't
+ * overlap, the text is then only returned when the end of it can't be the
+ * start of another match, so that a match can be found searching backward.
+ */
+    static char_u *
+search_literal(regmmatch_T *regmatch)
+{
+    char_u	*lit;
+    int		len;
+    int		i;
+
+    if (enc_dbcs != 0)
+	return NULL;
+    lit = re_literal(regmatch->regprog, regmatch->rmm_ic);
+    if (lit != NULL && vim_strchr(p_cpo, CPO_SEARCH) != NULL)
+    {
+	len = (int)STRLEN(lit);
+	for (i = 1; i < len; ++i)
+	    if (STRNCMP(lit, lit + i, len - i) == 0)
+	    {
+		VIM_CLEAR(lit);
+		break;
+	    }
+    }
+    return lit;
+}
+
+/*
+ * Return TRUE when the matches of "pat" may depend on the cursor position,
+ * the Visual area, marks, the last substitute string or options, thus they
+ * can't be kept for the next search.
+ */
+    static int
+search_pat_uses_state(char_u *pat)
+{
+    char_u	*p;
+
+    if (vim_strchr(pat, '~') != NULL)
+	return TRUE;
+    for (p = pat; (p = vim_strchr(p, '%')) != NULL; ++p)
+    {
+	if (p[1] == '<' || p[1] == '>')
+	    ++p;
+	if (p[1] == '\'' || p[1] == 'V' || p[1] == '.'
+					     || (p[1] == '#' && p[2] != '='))
+	    return TRUE;
+	while (VIM_ISDIGIT(p[1]))
+	    ++p;
+	if (p[1] == 'v')
+	    return TRUE;
+    }
+    return FALSE;
+}
+
+/*
+ * Find all the matches of "regmatch" in line "lnum", the same way a backward
+ * search does, and keep them in "search_cache".
+ * Returns FAIL when a match is not within the line or there is an error.
+ */
+    static int
+search_cache_fill(
+    regmmatch_T	*regmatch,
+    win_T	*win,
+    buf_T	*buf,
+    linenr_T	lnum,
+    proftime_T	*tm UNUSED,
+    int		*timed_out UNUSED)
+{
+    int		cpo_search = vim_strchr(p_cpo, CPO_SEARCH) != NULL;
+    colnr_T	col = 0;
+    char_u	*ptr;
+    searchmatch_T *sm;
+
+    search_cache.sc_fnum = 0;
+    if (search_cache.sc_matches.ga_itemsize == 0)
+	ga_init2(&search_cache.sc_matches, sizeof(searchmatch_T), 100);
+    search_cache.sc_matches.ga_len = 0;
+
+    while (vim_regexec_multi(regmatch, win, buf, lnum, col,
+#ifdef FEAT_RELTIME
+						tm, timed_out
+#else
+						NULL, NULL
+#endif
+						) > 0)
+    {
+	if (regmatch->startpos[0].lnum != 0 || regmatch->endpos[0].lnum != 0
+		|| ga_grow(&search_cache.sc_matches, 1) == FAIL)
+	    return FAIL;
+	sm = (searchmatch_T *)search_cache.sc_matches.ga_data
+					       + search_cache.sc_matches.ga_len;
+	sm->sm_start = regmatch->startpos[0].col;
+	sm->sm_end = regmatch->endpos[0].col;
+#ifdef FEAT_EVAL
+	sm->sm_submatch = first_submatch(regmatch);
+#else
+	sm->sm_submatch = 0;
+#endif
+	++search_cache.sc_matches.ga_len;
+
+	// If vi-compatible searching, continue at the end of the match,
+	// otherwise continue one position forward.  For an empty match always
+	// advance one character.
+	ptr = ml_get_buf(buf, lnum, FALSE);
+	col = cpo_search ? sm->sm_end : sm->sm_start;
+	if ((!cpo_search || col == sm->sm_start) && ptr[col] != NUL)
+	    col += has_mbyte ? (*mb_ptr2len)(ptr + col) : 1;
+	if (ptr[col] == NUL)
+	    break;
+    }
+    if (called_emsg
+#ifdef FEAT_RELTIME
+	    || (timed_out != NULL && *timed_out)
+#endif
+	    )
+	return FAIL;
+
+    vim_free(search_cache.sc_pat);
+    search_cache.sc_pat = vim_strsave(mr_pattern);
+    if (search_cache.sc_pat == NULL)
+	return FAIL;
+    search_cache.sc_fnum = buf->b_fnum;
+    search_cache.sc_changedtick = CHANGEDTICK(buf);
+    search_cache.sc_lnum = lnum;
+    search_cache.sc_magic = mr_magic;
+    search_cache.sc_ic = regmatch->rmm_ic;
+    search_cache.sc_cpo_search = cpo_search;
+    search_cache.sc_chartab_tick = chartab_tick;
+    return OK;
+}
+
+/*
+ * Find the last match of "regmatch" in line "lnum", for a backward search.
+ * The match must start at or after "mincol".  The start column, or with
+ * "use_end" the last column of the match, must be before "limit".
+ * When "lit" is not NULL it is the literal text the pattern matches, it is
+ * then searched for backward from "limit".  Otherwise the matches kept in
+ * "search_cache" are used, finding them when needed.
+ * Returns -1 when neither can be used, zero when there is no match and one
+ * when "matchpos", "endpos" and "submatch" were set.
+ */
+    static long
+search_backward_fast(
+    regmmatch_T	*regmatch,
+    win_T	*win,
+    buf_T	*buf,
+    linenr_T	lnum,
+    colnr_T	mincol,
+    long	limit,
+    int		use_end,
+    char_u	*lit,
+    lpos_T	*matchpos,
+    lpos_T	*endpos,
+    int		*submatch,
+    proftime_T	*tm,
+    int		*timed_out)
+{
+    char_u	    *line;
+    searchmatch_T   *sm;
+    long	    len;
+    long	    col;
+    int		    idx;
+
+    matchpos->lnum = 0;
+    matchpos->col = 0;
+    endpos->lnum = 0;
+    endpos->col = 0;
+    if (lit != NULL)
+    {
+	line = ml_get_buf(buf, lnum, FALSE);
+	len = (long)STRLEN(lit);
+	col = use_end ? limit - len : limit - 1;
+	if (col > (long)STRLEN(line) - len)
+	    col = (long)STRLEN(line) - len;
+	for ( ; col >= (long)mincol; --col)
+	    if (line[col] == *lit && STRNCMP(line + col, lit, len) == 0
+		    && !(enc_utf8
+			   && utf_iscomposing(utf_ptr2char(line + col + len))))
+		break;
+	if (col < (long)mincol)
+	    return 0L;
+	matchpos->col = (colnr_T)col;
+	endpos->col = (colnr_T)(col + len);
+	*submatch = 0;
+	return 1L;
+    }
+
+    if (mincol != 0 || re_multiline(regmatch->regprog)
+					     || search_pat_uses_state(mr_pattern))
+	return -1L;
+    if (search_cache.sc_fnum != buf->b_fnum
+	    || search_cache.sc_lnum != lnum
+	    || search_cache.sc_changedtick != CHANGEDTICK(buf)
+	    || search_cache.sc_chartab_tick != chartab_tick
+	    || search_cache.sc_magic != mr_magic
+	    || search_cache.sc_ic != regmatch->rmm_ic
+	    || search_cache.sc_cpo_search
+				   != (vim_strchr(p_cpo, CPO_SEARCH) != NULL)
+	    || STRCMP(search_cache.sc_pat, mr_pattern) != 0)
+    {
+	if (search_cache_fill(regmatch, win, buf, lnum, tm, timed_out)
+									== FAIL)
+	    return called_emsg
+#ifdef FEAT_RELTIME
+			|| (timed_out != NULL && *timed_out)
+#endif
+			    ? 0L : -1L;
+    }
+
+    // Use the last match before "limit", stop at the first one that isn't,
+    // like when searching for the matches one by one.
+    sm = (searchmatch_T *)search_cache.sc_matches.ga_data;
+    for (idx = 0; idx < search_cache.sc_matches.ga_len; ++idx)
+	if ((use_end ? (long)sm[idx].sm_end - 1 : (long)sm[idx].sm_start)
+								     >= limit)
+	    break;
+    if (idx == 0)
+	return 0L;
+    --idx;
+    matchpos->col = sm[idx].sm_start;
+    endpos->col = sm[idx].sm_end;
+    *submatch = sm[idx].sm_submatch;
+    return 1L;
+}
+
 /*
  * Lowest level search function.
  * Search for 'count'th occurrence of pattern "pat" in direction "dir".
@@ -627,6 +884,8 @@ searchit(
     int		submatch = 0;
     int		first_match = TRUE;
     int		save_called_emsg = called_emsg;
+    char_u	*lit = NULL;
+    int		fast;
 #ifdef FEAT_SEARCH_EXTRA
     int		break_loop = FALSE;
 #endif
@@ -639,6 +898,11 @@ searchit(
 	return FAIL;
     }
 
+    // A literal text can be found backward without finding the matches
+    // before it.
+    if (dir == BACKWARD)
+	lit = search_literal(&regmatch);
+
     /*
      * find the string
      */
@@ -724,7 +988,17 @@ searchit(
 		 */
 		col = at_first_line && (options & SEARCH_COL) ? pos->col
 								 : (colnr_T)0;
-		nmatched = vim_regexec_multi(&regmatch, win, buf,
+		nmatched = -1;
+		if (dir == BACKWARD)
+		    nmatched = search_backward_fast(&regmatch, win, buf,
+			    lnum, col, !loop && lnum == start_pos.lnum
+				? (long)start_pos.col + extra_col : (long)MAXCOL,
+			    options & SEARCH_END, lit, &matchpos, &endpos,
+			    &submatch, tm, timed_out);
+		fast = nmatched >= 0;
+		if (!fast)
+		{
+		    nmatched = vim_regexec_multi(&regmatch, win, buf,
 					     lnum, col,
 #ifdef FEAT_RELTIME
 					     tm, timed_out
@@ -732,6 +1006,10 @@ searchit(
 					     NULL, NULL
 #endif
 						      );
+		    /* match may actually be in another line when using \zs */
+		    matchpos = regmatch.startpos[0];
+		    endpos = regmatch.endpos[0];
+		}
 		/* Abort searching on an error (e.g., out of stack). */
 		if (called_emsg
 #ifdef FEAT_RELTIME
@@ -741,11 +1019,9 @@ searchit(
 		    break;
 		if (nmatched > 0)
 		{
-		    /* match may actually be in another line when using \zs */
-		    matchpos = regmatch.startpos[0];
-		    endpos = regmatch.endpos[0];
 #ifdef FEAT_EVAL
-		    submatch = first_submatch(&regmatch);
+		    if (!fast)
+			submatch = first_submatch(&regmatch);
 #endif
 		    /* "lnum" may be past end of buffer for "\n\zs". */
 		    if (lnum + matchpos.lnum > buf->b_ml.ml_line_count)
@@ -844,7 +1120,7 @@ searchit(
 			if (!match_ok)
 			    continue;
 		    }
-		    if (dir == BACKWARD)
+		    if (dir == BACKWARD && !fast)
 		    {
 			/*
 			 * Now, if there are multiple matches on this line,
@@ -1081,6 +1357,7 @@ searchit(
     while (--count > 0 && found);   /* stop after count matches or no match */
 
     vim_regfree(regmatch.regprog);
+    vim_free(lit);
 
     called_emsg |= save_called_emsg;
 
@@ -482,6 +482,9 @@ typedef struct mf_hashtab_S
  * The used list is a doubly linked list, most recently used block first.
  *	The blocks in the used list have a block of memory allocated.
  *	mf_used_count is the number of pages in the used list.
+ *	The list has two parts, see "2Q" in memfile.c: the hot blocks (with
+ *	BH_HOT set) come first, then the probation blocks, starting at
+ *	mf_used_mid.
  * The hash lists are used to quickly find a block in the used list.
  * The free list is a single linked list, not sorted.
  *	The blocks in the free list have no block of memory allocated and
@@ -497,10 +500,14 @@ struct block_hdr
     bhdr_T	*bh_prev;	    // previous block_hdr in used list
     char_u	*bh_data;	    // pointer to memory (for used block)
     int		bh_page_count;	    // number of pages in this block
+    int		bh_comp_len;	    // size of bh_data when BH_COMPRESSED
 
 #define BH_DIRTY    1
 #define BH_LOCKED   2
-    char	bh_flags;	    // BH_DIRTY or BH_LOCKED
+#define BH_HOT	    4
+#define BH_COMPRESSED 8		    // bh_data is compressed
+#define BH_NOCOMPRESS 16	    // compressing bh_data does not help
+    char	bh_flags;	    // BH_ flags above
 };
 
 /*
@@ -519,6 +526,22 @@ struct nr_trans
     blocknr_T	nt_new_bnum;		// new, positive, number
 };
 
+/*
+ * Number of a block that was recently released from the probation part of
+ * the used list.  The structure is the same as the hash lists, the entries
+ * are also in a double linked list, oldest first.
+ */
+typedef struct mf_ghost_S mf_ghost_T;
+
+struct mf_ghost_S
+{
+    mf_hashitem_T mg_hashitem;		// header for hash table and key
+#define mg_bnum mg_hashitem.mhi_key	// block number
+
+    mf_ghost_T	*mg_next;		// next newer entry
+    mf_ghost_T	*mg_prev;		// previous older entry
+};
+
 
 typedef struct buffblock buffblock_T;
 typedef struct buffheader buffheader_T;
@@ -646,10 +669,26 @@ struct memfile
     bhdr_T	*mf_free_first;		// first block_hdr in free list
     bhdr_T	*mf_used_first;		// mru block_hdr in used list
     bhdr_T	*mf_used_last;		// lru block_hdr in used list
+    bhdr_T	*mf_used_mid;		// first probation block_hdr in used
+					// list, NULL if there is none
     unsigned	mf_used_count;		// number of pages in used list
     unsigned	mf_used_count_max;	// maximum number of pages in memory
+    unsigned	mf_probation_count;	// number of probation pages
+    unsigned	mf_compressed_count;	// number of compressed pages
+    bhdr_T	*mf_compress_next;	// block where mf_compress() continues,
+					// NULL to start with mf_used_first
+    int		mf_compress_done;	// no block left for mf_compress()
     mf_hashtab_T mf_hash;		// hash lists
     mf_hashtab_T mf_trans;		// trans lists
+    mf_hashtab_T mf_ghost;		// ghost lists
+    mf_ghost_T	*mf_ghost_first;	// oldest entry in mf_ghost
+    mf_ghost_T	*mf_ghost_last;		// newest entry in mf_ghost
+    long	mf_stat_hits;		// mf_get() found block in memory
+    long	mf_stat_misses;		// mf_get() had to read the block
+    long	mf_stat_ghost_hits;	// misses for a block in mf_ghost
+    long	mf_stat_evictions;	// blocks released by mf_release()
+    long	mf_stat_reads;		// blocks read from the swap file
+    long	mf_stat_writes;		// writes to the swap file
     blocknr_T	mf_blocknr_max;		// highest positive block number + 1
     blocknr_T	mf_blocknr_min;		// lowest negative block number - 1
     blocknr_T	mf_neg_count;		// number of negative blocks numbers
@@ -699,6 +738,20 @@ typedef struct ml_chunksize
 # define ML_CHNK_UPDLINE 3
 #endif
 
+/*
+ * Location of a data block, remembered to avoid going through the pointer
+ * blocks when a line in it is needed again.
+ */
+typedef struct mlblock_S
+{
+    blocknr_T	mb_bnum;	// block number, zero when not used
+    int		mb_page_count;	// number of pages in the block
+    linenr_T	mb_low;		// first line in the block
+    linenr_T	mb_high;	// last line in the block
+} mlblock_T;
+
+#define ML_BLOCK_CACHE_SIZE 8	// nr of entries in ml_block_cache
+
 /*
  * the memline structure holds all the information about a memline
  */
@@ -712,6 +765,8 @@ typedef struct memline
 #define ML_LINE_DIRTY	2	// cached line was changed and allocated
 #define ML_LOCKED_DIRTY	4	// ml_locked was changed
 #define ML_LOCKED_POS	8	// ml_locked needs positive block number
+#define ML_LOCKED_NOSTACK 16	// ml_locked found in ml_block_cache, the
+				// stack does not lead to it
     int		ml_flags;
 
     infoptr_T	*ml_stack;	// stack of pointer blocks (array of IPTRs)
@@ -726,10 +781,24 @@ typedef struct memline
     linenr_T	ml_locked_low;	// first line in ml_locked
     linenr_T	ml_locked_high;	// last line in ml_locked
     int		ml_locked_lineadd;  // number of lines inserted in ml_locked
+
+    mlblock_T	ml_block_cache[ML_BLOCK_CACHE_SIZE];
+				// recently used data blocks
+    int		ml_block_cache_next;  // entry to be replaced next
+
+    long	ml_stat_lookups;    // nr of times a line was looked up
+    long	ml_stat_locked_hits; // nr of times it was in ml_locked
+    long	ml_stat_cache_hits; // nr of times it was in ml_block_cache
 #ifdef FEAT_BYTEOFF
     chunksize_T *ml_chunksize;
     int		ml_numchunks;
     int		ml_usedchunks;
+    chunksize_T *ml_chunktree;	// Fenwick tree with sums of ml_chunksize
+    int		ml_chunktree_ok; // ml_chunktree matches ml_chunksize
+#endif
+#ifdef FEAT_TEXT_PROP
+    garray_T	ml_prop_lines;	// sorted numbers of the lines that have text
+				// properties, not updated for the cached line
 #endif
 } memline_T;
 
@@ -2075,6 +2144,10 @@ typedef struct {
     long	count;		// nr of times used
     long	match;		// nr of times matched
 } syn_time_T;
+
+# define SYNTIME_LINES	100	// nr of lines for one syn_time_T in
+				// b_syn_time_lines
+# define SYNTIME_DEPTH	10	// nr of entries in b_syn_time_depth[]
 #endif
 
 typedef struct timer_S timer_T;
@@ -2165,6 +2238,13 @@ typedef struct {
     regprog_T	*b_syn_linecont_prog;	// line continuation program
 #ifdef FEAT_PROFILE
     syn_time_T  b_syn_linecont_time;
+    garray_T	b_syn_time_lines;	// syn_time_T for every SYNTIME_LINES
+					// lines
+    syn_time_T	b_syn_time_depth[SYNTIME_DEPTH]; // time for each region
+					// nesting depth, the last one
+					// includes deeper nesting
+    long	b_syn_time_smc;		// nr of lines cut off by 'synmaxcol'
+    long	b_syn_time_rdt;		// nr of times 'redrawtime' was reached
 #endif
     int		b_syn_linecont_ic;	// ignore-case flag for above
     int		b_syn_topgrp;		// for ":syntax include"
@@ -2188,6 +2268,10 @@ typedef struct {
      * b_sst_freecount	number of free entries in b_sst_array[]
      * b_sst_check_lnum	entries after this lnum need to be checked for
      *			validity (MAXLNUM means no check needed)
+     * b_sst_idle_lnum	lines up to this one were parsed while waiting for
+     *			the user to type, see syntax_idle_parse()
+     * b_sst_hint	entry in the list of used entries to start looking
+     *			from in syn_stack_find_entry() or NULL
      */
     synstate_T	*b_sst_array;
     int		b_sst_len;
@@ -2195,6 +2279,8 @@ typedef struct {
     synstate_T	*b_sst_firstfree;
     int		b_sst_freecount;
     linenr_T	b_sst_check_lnum;
+    linenr_T	b_sst_idle_lnum;
+    synstate_T	*b_sst_hint;
     short_u	b_sst_lasttick;	// last display tick
 #endif // FEAT_SYN_HL
 
@@ -2913,11 +2999,18 @@ struct matchitem
     regmmatch_T	match;	    // regexp program for pattern
     posmatch_T	pos;	    // position matches
     match_T	hl;	    // struct for doing the actual highlighting
+    int		lit_idx;    // index in w_match_lit when "pattern" is a
+			    // literal string, -1 otherwise
+    matchitem_T	*next_active; // next match in w_match_active
 #ifdef FEAT_CONCEAL
     int		conceal_char; // cchar for Conceal highlighting
 #endif
 };
 
+// Automaton to find the literal match patterns of a window in a line at
+// once, defined in highlight.c.
+typedef struct matchlit_S matchlit_T;
+
 // Structure to store last cursor position and topline.  Used by check_lnums()
 // and reset_lnums().
 typedef struct
@@ -2936,6 +3029,53 @@ typedef struct {
 } winbar_item_T;
 #endif
 
+/*
+ * What a cached status line or status line item depends on.  Compared with
+ * memcmp(), thus must be cleared before filling it.
+ */
+typedef struct
+{
+    int		sk_tick;	// stl_cache_tick
+    int		sk_fnum;	// buffer number
+    varnumber_T	sk_changedtick;	// b:changedtick
+    int		sk_changed;	// 'modified'
+    int		sk_readonly;	// 'readonly'
+    pos_T	sk_cursor;	// cursor position
+    linenr_T	sk_topline;	// first and last line in the window
+    linenr_T	sk_botline;
+    int		sk_state;	// State
+    int		sk_width;	// window size
+    int		sk_height;
+    int		sk_curwin;	// TRUE for the current window
+    int		sk_fillchar;	// fill character used
+    int		sk_maxwidth;	// available width
+} stlkey_T;
+
+/*
+ * Cached result of a "%{=flags:expr}" status line item.
+ */
+typedef struct
+{
+    char_u	*sti_expr;	// the expression
+    stlkey_T	sti_key;
+    char_u	*sti_fname;	// file name for the "f" flag
+    char_u	*sti_value;	// result, NULL when not evaluated
+} stlitem_T;
+
+/*
+ * Cached status line, ruler or tab page line, see 'statuslinecache'.
+ */
+typedef struct
+{
+    char_u	*sc_fmt;	// option value the cache is for
+    stlkey_T	sc_key;
+    char_u	*sc_fname;	// file name of the buffer
+    char_u	*sc_text;	// resulting text, NULL when not valid
+    struct stl_hlrec *sc_hltab;	// highlight, "start" points in sc_text
+    struct stl_hlrec *sc_tabtab; // tab page numbers, idem
+    garray_T	sc_items;	// stlitem_T for the items with a cache hint
+} stlcache_T;
+
 /*
  * Structure which contains all information that belongs to a window
  *
@@ -3159,6 +3299,10 @@ struct window_S
     linenr_T	w_redraw_top;	    // when != 0: first line needing redraw
     linenr_T	w_redraw_bot;	    // when != 0: last line needing redraw
     int		w_redr_status;	    // if TRUE status line must be redrawn
+#ifdef FEAT_STL_OPT
+    stlcache_T	*w_stl_cache;	    // cached 'statusline'
+    stlcache_T	*w_ruf_cache;	    // cached 'rulerformat'
+#endif
 
 #ifdef FEAT_CMDL_INFO
     // remember what is shown in the ruler for this window (if 'ruler' set)
@@ -3249,6 +3393,10 @@ struct window_S
 #ifdef FEAT_SEARCH_EXTRA
     matchitem_T	*w_match_head;		// head of match list
     int		w_next_match_id;	// next match ID
+    matchitem_T	*w_match_active;	// matches in the line being drawn,
+					// linked with "next_active"
+    matchlit_T	*w_match_lit;		// literal patterns in the match list
+    int		w_match_lit_valid;	// w_match_lit is up to date
 #endif
 
     /*
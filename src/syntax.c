@@ -58,6 +58,8 @@ typedef struct syn_pattern
     int		 sp_sync_idx;		/* sync item index (syncing only) */
     int		 sp_line_id;		/* ID of last line where tried */
     int		 sp_startcol;		/* next match in sp_line_id line */
+    char_u	 sp_first[32];		/* bit set for each byte a match can
+					   start with, all set when unknown */
     short	*sp_cont_list;		/* cont. group IDs, if non-zero */
     short	*sp_next_list;		/* next group IDs, if non-zero */
     struct sp_syn sp_syn;		/* struct passed to in_id_list() */
@@ -266,6 +268,10 @@ static buf_T	*syn_buf;		/* current buffer for highlighting */
 static synblock_T *syn_block;		/* current buffer for highlighting */
 #ifdef FEAT_RELTIME
 static proftime_T *syn_tm;		/* timeout limit */
+static int	syn_tm_idle = FALSE;	/* "syn_tm" is for parsing while
+					   waiting for a character */
+static int	syn_idle_timed_out = FALSE; /* "syn_tm" passed while parsing
+					   waiting for a character */
 #endif
 static linenr_T current_lnum = 0;	/* lnum of current state */
 static colnr_T	current_col = 0;	/* column of current state */
@@ -277,12 +283,15 @@ static garray_T current_state		/* current stack of state_items */
 static short	*current_next_list = NULL; /* when non-zero, nextgroup list */
 static int	current_next_flags = 0; /* flags for current_next_list */
 static int	current_line_id = 0;	/* unique number for current line */
+static int	line_bytes_id = -1;	/* current_line_id for line_bytes[] */
+static char_u	line_bytes[32];		/* bit set for each byte in the line */
 
 #define CUR_STATE(idx)	((stateitem_T *)(current_state.ga_data))[idx]
 
 static void syn_sync(win_T *wp, linenr_T lnum, synstate_T *last_valid);
 static int syn_match_linecont(linenr_T lnum);
 static void syn_start_line(void);
+static int syn_line_can_match(synpat_T *spp);
 static void syn_update_ends(int startofline);
 static void syn_stack_alloc(void);
 static int syn_stack_cleanup(void);
@@ -307,8 +316,11 @@ static int push_current_state(int idx);
 static void pop_current_state(void);
 #ifdef FEAT_PROFILE
 static void syn_clear_time(syn_time_T *tt);
+static void syn_add_time(syn_time_T *st, proftime_T *tm, int matched);
+static void syntime_clear_block(synblock_T *block);
 static void syntime_clear(void);
 static void syntime_report(void);
+static void syntime_report_block(synblock_T *block);
 static int syn_time_on = FALSE;
 # define IF_SYN_TIME(p) (p)
 #else
@@ -415,6 +427,14 @@ syntax_start(win_T *wp, linenr_T lnum)
 	    && current_lnum < syn_buf->b_ml.ml_line_count)
     {
 	(void)syn_finish_line(FALSE);
+#ifdef FEAT_RELTIME
+	// The state is wrong when the time limit was passed halfway the line.
+	if (syn_idle_timed_out)
+	{
+	    invalidate_current_state();
+	    return;
+	}
+#endif
 	if (!current_state_stored)
 	{
 	    ++current_lnum;
@@ -484,6 +504,14 @@ syntax_start(win_T *wp, linenr_T lnum)
     {
 	syn_start_line();
 	(void)syn_finish_line(FALSE);
+#ifdef FEAT_RELTIME
+	if (syn_idle_timed_out)
+	{
+	    // Don't store the wrong state, the caller invalidates it.
+	    current_lnum = lnum;
+	    break;
+	}
+#endif
 	++current_lnum;
 
 	/* If we parsed at least "minlines" lines or started at a valid
@@ -537,6 +565,18 @@ syntax_start(win_T *wp, linenr_T lnum)
 	    current_lnum = lnum;
 	    break;
 	}
+#ifdef FEAT_RELTIME
+	// When parsing in the background stop at the time limit.  Keep the
+	// state of the parsed lines to continue from there next time.
+	if (syn_tm_idle && current_lnum < lnum && profile_passed_limit(syn_tm))
+	{
+	    if (current_lnum >= first_stored && !current_state_stored)
+		(void)store_current_state();
+	    syn_idle_timed_out = TRUE;
+	    current_lnum = lnum;
+	    break;
+	}
+#endif
     }
 
     syn_start_line();
@@ -934,6 +974,32 @@ syn_start_line(void)
 #endif
 }
 
+/*
+ * Return TRUE if the current line contains a byte that a match of "spp" can
+ * start with.  This is much cheaper than trying the regexp.  The NUL at the
+ * end of the line is included, it is set in sp_first[] when the start of a
+ * match is not known.
+ */
+    static int
+syn_line_can_match(synpat_T *spp)
+{
+    char_u	*p;
+    int		i;
+
+    if (line_bytes_id != current_line_id)
+    {
+	vim_memset(line_bytes, 0, sizeof(line_bytes));
+	line_bytes[0] = 1;
+	for (p = syn_getcurline(); *p != NUL; ++p)
+	    line_bytes[*p >> 3] |= 1 << (*p & 7);
+	line_bytes_id = current_line_id;
+    }
+    for (i = 0; i < (int)sizeof(line_bytes); ++i)
+	if (line_bytes[i] & spp->sp_first[i])
+	    return TRUE;
+    return FALSE;
+}
+
 /*
  * Check for items in the stack that need their end updated.
  * When "startofline" is TRUE the last item is always updated.
@@ -1052,6 +1118,8 @@ syn_stack_free_block(synblock_T *block)
 	block->b_sst_first = NULL;
 	block->b_sst_len = 0;
     }
+    block->b_sst_idle_lnum = 0;
+    block->b_sst_hint = NULL;
 }
 /*
  * Free b_sst_array[] for buffer "buf".
@@ -1152,6 +1220,7 @@ syn_stack_alloc(void)
 	vim_free(syn_block->b_sst_array);
 	syn_block->b_sst_array = sstp;
 	syn_block->b_sst_len = len;
+	syn_block->b_sst_hint = NULL;
     }
 }
 
@@ -1181,6 +1250,10 @@ syn_stack_apply_changes_block(synblock_T *block, buf_T *buf)
     synstate_T	*p, *prev, *np;
     linenr_T	n;
 
+    // Parsing in the background needs to start again above the change.
+    if (block->b_sst_idle_lnum >= buf->b_mod_top)
+	block->b_sst_idle_lnum = buf->b_mod_top - 1;
+
     prev = NULL;
     for (p = block->b_sst_first; p != NULL; )
     {
@@ -1220,6 +1293,146 @@ syn_stack_apply_changes_block(synblock_T *block, buf_T *buf)
     }
 }
 
+/*
+ * Number of lines syntax_idle_parse() parses with one call to
+ * syntax_start().  It continues from the state stored at the end of the
+ * previous call when "minlines" is at least this.
+ */
+#define SYN_IDLE_CHUNK	200
+
+/*
+ * Return TRUE when parsing further down in the buffer of window "wp" while
+ * waiting for the user to type is useful.  That is when syncing may start far
+ * back, such as with ":syntax sync fromstart".  Otherwise jumping to a line
+ * only needs to parse a limited number of lines anyway.
+ */
+    static int
+syn_idle_needed(win_T *wp)
+{
+    synblock_T	*block = wp->w_s;
+
+    return block->b_sst_array != NULL
+	    && block->b_syn_sync_minlines >= SYN_IDLE_CHUNK
+	    && !block->b_syn_slow
+	    && !wp->w_buffer->b_mod_set
+	    && wp->w_buffer->b_ml.ml_mfp != NULL
+	    && block->b_sst_idle_lnum < wp->w_buffer->b_ml.ml_line_count
+	    && syntax_present(wp);
+}
+
+/*
+ * Return TRUE when syntax_idle_parse() has something to do.
+ */
+    int
+syntax_idle_pending(void)
+{
+    win_T	*wp;
+
+    // Not while the screen is being updated, the current state is in use.
+    if (updating_screen || must_redraw != 0)
+	return FALSE;
+    FOR_ALL_WINDOWS(wp)
+	if (syn_idle_needed(wp))
+	    return TRUE;
+    return FALSE;
+}
+
+/*
+ * Parse the syntax further down in the buffer of a window in the current tab
+ * page, for about "msec" msec.  Called while waiting for the user to type.
+ * States are stored in b_sst_array[] every so many lines, like when lines are
+ * displayed.  Jumping to a line or scrolling then finds a stored state nearby,
+ * instead of parsing from far above, which may take longer than 'redrawtime'.
+ */
+    void
+syntax_idle_parse(long msec UNUSED)
+{
+    win_T	*wp;
+    synblock_T	*block;
+    synstate_T	*p;
+    linenr_T	lnum;
+    linenr_T	line_count;
+#ifdef FEAT_RELTIME
+    proftime_T	tm;
+    proftime_T	*save_tm;
+
+    profile_setlimit(msec, &tm);
+#endif
+    if (!syntax_idle_pending())
+	return;
+    FOR_ALL_WINDOWS(wp)
+	if (syn_idle_needed(wp))
+	    break;
+    block = wp->w_s;
+    line_count = wp->w_buffer->b_ml.ml_line_count;
+
+    for (;;)
+    {
+	// Skip over lines for which valid states were already stored, e.g.
+	// when they were displayed.
+	lnum = block->b_sst_idle_lnum;
+	for (p = block->b_sst_first; p != NULL
+			     && p->sst_lnum <= lnum + SYN_IDLE_CHUNK; p = p->sst_next)
+	    if (p->sst_lnum > lnum)
+	    {
+		if (p->sst_change_lnum != 0)
+		    break;
+		lnum = p->sst_lnum;
+	    }
+
+	lnum += SYN_IDLE_CHUNK;
+	if (lnum > line_count)
+	    lnum = line_count;
+#ifdef FEAT_RELTIME
+	// Use the time limit like 'redrawtime', so that parsing stops halfway
+	// the chunk.
+	save_tm = syn_tm;
+	syn_tm = &tm;
+	syn_tm_idle = TRUE;
+	syn_idle_timed_out = FALSE;
+#endif
+	syntax_start(wp, lnum);
+#ifdef FEAT_RELTIME
+	syn_tm = save_tm;
+	syn_tm_idle = FALSE;
+	if (syn_idle_timed_out)
+	{
+	    linenr_T	done_lnum = block->b_sst_idle_lnum;
+
+	    // The state is wrong when stopped halfway, continue from the last
+	    // state that was stored next time.
+	    invalidate_current_state();
+	    for (p = block->b_sst_first; p != NULL && p->sst_lnum <= lnum;
+							       p = p->sst_next)
+		if (p->sst_lnum > done_lnum && p->sst_change_lnum == 0)
+		    done_lnum = p->sst_lnum;
+	    if (done_lnum > block->b_sst_idle_lnum)
+		block->b_sst_idle_lnum = done_lnum;
+	    else
+		// Not even one line could be parsed in the time, trying again
+		// would keep the CPU busy without getting anywhere.
+		block->b_sst_idle_lnum = line_count;
+	    break;
+	}
+#endif
+	if (got_int)
+	{
+	    // The state is wrong when interrupted.
+	    invalidate_current_state();
+	    break;
+	}
+	block->b_sst_idle_lnum = lnum;
+	if (lnum >= line_count)
+	    break;
+#ifdef FEAT_RELTIME
+	if (profile_passed_limit(&tm))
+	    break;
+#else
+	break;
+#endif
+    }
+}
+
 /*
  * Reduce the number of entries in the state stack for syn_buf.
  * Returns TRUE if at least one entry was freed.
@@ -1295,11 +1508,14 @@ syn_stack_free_entry(synblock_T *block, synstate_T *p)
     p->sst_next = block->b_sst_firstfree;
     block->b_sst_firstfree = p;
     ++block->b_sst_freecount;
+    block->b_sst_hint = NULL;
 }
 
 /*
  * Find an entry in the list of state stacks at or before "lnum".
  * Returns NULL when there is no entry or the first entry is after "lnum".
+ * Lines are mostly parsed from top to bottom, thus start at the entry found
+ * the previous time when possible, instead of going over the whole list.
  */
     static synstate_T *
 syn_stack_find_entry(linenr_T lnum)
@@ -1307,14 +1523,24 @@ syn_stack_find_entry(linenr_T lnum)
     synstate_T	*p, *prev;
 
     prev = NULL;
-    for (p = syn_block->b_sst_first; p != NULL; prev = p, p = p->sst_next)
+    p = syn_block->b_sst_first;
+    if (syn_block->b_sst_hint != NULL
+				     && syn_block->b_sst_hint->sst_lnum <= lnum)
+	p = syn_block->b_sst_hint;
+    for ( ; p != NULL; prev = p, p = p->sst_next)
     {
 	if (p->sst_lnum == lnum)
-	    return p;
+	    break;
 	if (p->sst_lnum > lnum)
+	{
+	    p = prev;
 	    break;
+	}
     }
-    return prev;
+    if (p == NULL)
+	p = prev;
+    syn_block->b_sst_hint = p;
+    return p;
 }
 
 /*
@@ -1718,6 +1944,16 @@ get_syntax_attr(
     /* After 'synmaxcol' the attribute is always zero. */
     if (syn_buf->b_p_smc > 0 && col >= (colnr_T)syn_buf->b_p_smc)
     {
+#ifdef FEAT_PROFILE
+	static int smc_line_id = 0;
+
+	/* Count each line only once. */
+	if (syn_time_on && smc_line_id != current_line_id)
+	{
+	    smc_line_id = current_line_id;
+	    ++syn_block->b_syn_time_smc;
+	}
+#endif
 	clear_current_state();
 #ifdef FEAT_EVAL
 	current_id = 0;
@@ -1978,6 +2214,14 @@ syn_current_attr(
 				continue;
 			    spp->sp_line_id = current_line_id;
 
+			    /* Skip the pattern when the line does not contain
+			     * a byte that a match can start with. */
+			    if (!syn_line_can_match(spp))
+			    {
+				spp->sp_startcol = MAXCOL;
+				continue;
+			    }
+
 			    lc_col = current_col - spp->sp_offsets[SPO_LC_OFF];
 			    if (lc_col < 0)
 				lc_col = 0;
@@ -3197,17 +3441,42 @@ syn_regexec(
 #ifdef FEAT_PROFILE
     if (syn_time_on)
     {
+	garray_T    *gap = &syn_block->b_syn_time_lines;
+	int	    i = (lnum - 1) / SYNTIME_LINES;
+	int	    depth = current_state.ga_len;
+
 	profile_end(&pt);
-	profile_add(&st->total, &pt);
-	if (profile_cmp(&pt, &st->slowest) < 0)
-	    st->slowest = pt;
-	++st->count;
-	if (r > 0)
-	    ++st->match;
+	syn_add_time(st, &pt, r > 0);
+
+	// Also add the time to the lines and the region nesting depth.
+	if (i >= gap->ga_len)
+	{
+	    if (gap->ga_itemsize == 0)
+		ga_init2(gap, sizeof(syn_time_T), 100);
+	    if (ga_grow(gap, i + 1 - gap->ga_len) == OK)
+	    {
+		vim_memset((syn_time_T *)gap->ga_data + gap->ga_len, 0,
+			      sizeof(syn_time_T) * (i + 1 - gap->ga_len));
+		gap->ga_len = i + 1;
+	    }
+	}
+	if (i < gap->ga_len)
+	    syn_add_time((syn_time_T *)gap->ga_data + i, &pt, r > 0);
+	if (depth >= SYNTIME_DEPTH)
+	    depth = SYNTIME_DEPTH - 1;
+	syn_add_time(&syn_block->b_syn_time_depth[depth], &pt, r > 0);
+# ifdef FEAT_RELTIME
+	if (timed_out && !syn_tm_idle)
+	    ++syn_block->b_syn_time_rdt;
+# endif
     }
 #endif
 #ifdef FEAT_RELTIME
-    if (timed_out && !syn_win->w_s->b_syn_slow)
+    // Passing the time limit while parsing in the background only stops the
+    // parsing, the syntax is not slow.
+    if (timed_out && syn_tm_idle)
+	syn_idle_timed_out = TRUE;
+    else if (timed_out && !syn_win->w_s->b_syn_slow)
     {
 	syn_win->w_s->b_syn_slow = TRUE;
 	msg(_("'redrawtime' exceeded, syntax highlighting disabled"));
@@ -3505,6 +3774,9 @@ syntax_clear(synblock_T *block)
     vim_regfree(block->b_syn_linecont_prog);
     block->b_syn_linecont_prog = NULL;
     VIM_CLEAR(block->b_syn_linecont_pat);
+#ifdef FEAT_PROFILE
+    syntime_clear_block(block);
+#endif
 #ifdef FEAT_FOLDING
     block->b_syn_folditems = 0;
 #endif
@@ -5619,6 +5891,8 @@ get_syn_pattern(char_u *arg, synpat_T *ci)
     if (ci->sp_prog == NULL)
 	return NULL;
     ci->sp_ic = curwin->w_s->b_syn_ic;
+    if (re_first_bytes(ci->sp_prog, ci->sp_ic, ci->sp_first) == FAIL)
+	vim_memset(ci->sp_first, 0xff, sizeof(ci->sp_first));
 #ifdef FEAT_PROFILE
     syn_clear_time(&ci->sp_time);
 #endif
@@ -6546,6 +6820,36 @@ syn_clear_time(syn_time_T *st)
     st->match = 0;
 }
 
+/*
+ * Add time "tm" of one try to "st".  "matched" is TRUE when there was a
+ * match.
+ */
+    static void
+syn_add_time(syn_time_T *st, proftime_T *tm, int matched)
+{
+    profile_add(&st->total, tm);
+    if (profile_cmp(tm, &st->slowest) < 0)
+	st->slowest = *tm;
+    ++st->count;
+    if (matched)
+	++st->match;
+}
+
+/*
+ * Clear the syntax timing for lines and nesting depth in "block".
+ */
+    static void
+syntime_clear_block(synblock_T *block)
+{
+    int		i;
+
+    ga_clear(&block->b_syn_time_lines);
+    for (i = 0; i < SYNTIME_DEPTH; ++i)
+	syn_clear_time(&block->b_syn_time_depth[i]);
+    block->b_syn_time_smc = 0;
+    block->b_syn_time_rdt = 0;
+}
+
 /*
  * Clear the syntax timing for the current buffer.
  */
@@ -6565,6 +6869,7 @@ syntime_clear(void)
 	spp = &(SYN_ITEMS(curwin->w_s)[idx]);
 	syn_clear_time(&spp->sp_time);
     }
+    syntime_clear_block(curwin->w_s);
 }
 
 /*
@@ -6595,6 +6900,8 @@ typedef struct
     char_u	*pattern;
 } time_entry_T;
 
+#define SYNTIME_REPORT_LINES 10	/* nr of line ranges in ":syntime report" */
+
     static int
 syn_compare_syntime(const void *v1, const void *v2)
 {
@@ -6703,7 +7010,244 @@ syntime_report(void)
 	msg_outnum(total_count);
 	msg_puts("\n");
     }
+    syntime_report_block(curwin->w_s);
 }
+
+/*
+ * Return the last line of the range of lines starting at "lnum" used for
+ * b_syn_time_lines.
+ */
+    static linenr_T
+syntime_range_end(linenr_T lnum)
+{
+    linenr_T	end = lnum + SYNTIME_LINES - 1;
+
+    if (end > curbuf->b_ml.ml_line_count)
+	end = curbuf->b_ml.ml_line_count;
+    return end;
+}
+
+/*
+ * Get the line ranges of "block" that took time in allocated memory, sorted
+ * on total time.  "id" is the first line of the range.
+ */
+    static void
+syntime_get_lines(synblock_T *block, garray_T *gap)
+{
+    int		idx;
+    syn_time_T	*st;
+    time_entry_T *p;
+
+    ga_init2(gap, sizeof(time_entry_T), 50);
+    for (idx = 0; idx < block->b_syn_time_lines.ga_len; ++idx)
+    {
+	st = (syn_time_T *)block->b_syn_time_lines.ga_data + idx;
+	if (st->count > 0 && ga_grow(gap, 1) == OK)
+	{
+	    p = ((time_entry_T *)gap->ga_data) + gap->ga_len;
+	    p->total = st->total;
+	    p->count = st->count;
+	    p->match = st->match;
+	    p->slowest = st->slowest;
+	    p->id = idx * SYNTIME_LINES + 1;
+	    p->pattern = NULL;
+	    ++gap->ga_len;
+	}
+    }
+    if (gap->ga_len > 1)
+	qsort(gap->ga_data, (size_t)gap->ga_len, sizeof(time_entry_T),
+							 syn_compare_syntime);
+}
+
+/*
+ * Report the time spent in the line ranges that took most time, the time
+ * for each region nesting depth and how often parsing was cut short.
+ */
+    static void
+syntime_report_block(synblock_T *block)
+{
+    garray_T	ga;
+    time_entry_T *p;
+    syn_time_T	*st;
+    int		idx;
+    int		did_header = FALSE;
+    char_u	buf[100];
+
+    syntime_get_lines(block, &ga);
+    if (ga.ga_len > 0 && !got_int)
+    {
+	msg_puts("\n");
+	msg_puts_title(_("  TOTAL      COUNT  MATCH   SLOWEST     LINES"));
+	msg_puts("\n");
+	for (idx = 0; idx < ga.ga_len && idx < SYNTIME_REPORT_LINES
+							   && !got_int; ++idx)
+	{
+	    p = ((time_entry_T *)ga.ga_data) + idx;
+	    msg_puts(profile_msg(&p->total));
+	    msg_puts(" ");
+	    msg_advance(13);
+	    msg_outnum(p->count);
+	    msg_puts(" ");
+	    msg_advance(20);
+	    msg_outnum(p->match);
+	    msg_puts(" ");
+	    msg_advance(26);
+	    msg_puts(profile_msg(&p->slowest));
+	    msg_puts(" ");
+	    msg_advance(38);
+	    vim_snprintf((char *)buf, sizeof(buf), "%d-%ld",
+				       p->id, (long)syntime_range_end(p->id));
+	    msg_puts((char *)buf);
+	    msg_puts("\n");
+	}
+    }
+    ga_clear(&ga);
+
+    for (idx = 0; idx < SYNTIME_DEPTH && !got_int; ++idx)
+    {
+	st = &block->b_syn_time_depth[idx];
+	if (st->count == 0)
+	    continue;
+	if (!did_header)
+	{
+	    did_header = TRUE;
+	    msg_puts("\n");
+	    msg_puts_title(_("  TOTAL      COUNT  MATCH   SLOWEST     DEPTH"));
+	    msg_puts("\n");
+	}
+	msg_puts(profile_msg(&st->total));
+	msg_puts(" ");
+	msg_advance(13);
+	msg_outnum(st->count);
+	msg_puts(" ");
+	msg_advance(20);
+	msg_outnum(st->match);
+	msg_puts(" ");
+	msg_advance(26);
+	msg_puts(profile_msg(&st->slowest));
+	msg_puts(" ");
+	msg_advance(38);
+	msg_outnum(idx);
+	if (idx == SYNTIME_DEPTH - 1)
+	    msg_puts("+");
+	msg_puts("\n");
+    }
+
+    if (block->b_syn_time_smc > 0 && !got_int)
+    {
+	msg_puts("\n");
+	vim_snprintf((char *)buf, sizeof(buf),
+		      _("'synmaxcol' reached in %ld lines"), block->b_syn_time_smc);
+	msg_puts((char *)buf);
+    }
+    if (block->b_syn_time_rdt > 0 && !got_int)
+    {
+	msg_puts("\n");
+	vim_snprintf((char *)buf, sizeof(buf),
+		       _("'redrawtime' reached %ld times"), block->b_syn_time_rdt);
+	msg_puts((char *)buf);
+    }
+}
+
+# if defined(FEAT_EVAL) || defined(PROTO)
+/*
+ * Add time "tm" to dictionary "d" as item "key".
+ */
+    static void
+syntime_dict_add_time(dict_T *d, char *key, proftime_T *tm)
+{
+#  ifdef FEAT_FLOAT
+    dict_add_float(d, key, profile_float(tm));
+#  else
+    dict_add_string(d, key, (char_u *)profile_msg(tm));
+#  endif
+}
+
+/*
+ * Append a dictionary with the times in "st" to list "l".
+ * Returns the dictionary, NULL when out of memory.
+ */
+    static dict_T *
+syntime_list_add(list_T *l, syn_time_T *st)
+{
+    dict_T	*d = dict_alloc();
+
+    if (d == NULL)
+	return NULL;
+    if (list_append_dict(l, d) == FAIL)
+    {
+	dict_unref(d);
+	return NULL;
+    }
+    syntime_dict_add_time(d, "total", &st->total);
+    syntime_dict_add_time(d, "slowest", &st->slowest);
+    dict_add_number(d, "count", st->count);
+    dict_add_number(d, "match", st->match);
+    return d;
+}
+
+/*
+ * "syntime_info()" function
+ */
+    void
+f_syntime_info(typval_T *argvars UNUSED, typval_T *rettv)
+{
+    synblock_T	*block = curwin->w_s;
+    list_T	*l;
+    dict_T	*d;
+    synpat_T	*spp;
+    syn_time_T	*st;
+    int		idx;
+    linenr_T	lnum;
+
+    if (rettv_dict_alloc(rettv) != OK)
+	return;
+
+    l = list_alloc();
+    if (l == NULL)
+	return;
+    dict_add_list(rettv->vval.v_dict, "patterns", l);
+    for (idx = 0; idx < block->b_syn_patterns.ga_len; ++idx)
+    {
+	spp = &(SYN_ITEMS(block)[idx]);
+	if (spp->sp_time.count > 0
+			    && (d = syntime_list_add(l, &spp->sp_time)) != NULL)
+	{
+	    dict_add_string(d, "name", highlight_group_name(spp->sp_syn.id - 1));
+	    dict_add_string(d, "pattern", spp->sp_pattern);
+	}
+    }
+
+    l = list_alloc();
+    if (l == NULL)
+	return;
+    dict_add_list(rettv->vval.v_dict, "lines", l);
+    for (idx = 0; idx < block->b_syn_time_lines.ga_len; ++idx)
+    {
+	st = (syn_time_T *)block->b_syn_time_lines.ga_data + idx;
+	if (st->count > 0 && (d = syntime_list_add(l, st)) != NULL)
+	{
+	    lnum = idx * SYNTIME_LINES + 1;
+	    dict_add_number(d, "lnum", lnum);
+	    dict_add_number(d, "end", syntime_range_end(lnum));
+	}
+    }
+
+    l = list_alloc();
+    if (l == NULL)
+	return;
+    dict_add_list(rettv->vval.v_dict, "depth", l);
+    for (idx = 0; idx < SYNTIME_DEPTH; ++idx)
+    {
+	st = &block->b_syn_time_depth[idx];
+	if (st->count > 0 && (d = syntime_list_add(l, st)) != NULL)
+	    dict_add_number(d, "depth", idx);
+    }
+
+    dict_add_number(rettv->vval.v_dict, "synmaxcol", block->b_syn_time_smc);
+    dict_add_number(rettv->vval.v_dict, "redrawtime", block->b_syn_time_rdt);
+}
+# endif
 #endif
 
 #endif /* FEAT_SYN_HL */
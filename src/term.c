@@ -76,6 +76,7 @@ struct builtin_term
 
 static void parse_builtin_tcap(char_u *s);
 static void gather_termleader(void);
+static void out_flush_now(void);
 #ifdef FEAT_TERMRESPONSE
 static void req_codes_from_term(void);
 static void req_more_codes_from_term(void);
@@ -950,6 +951,8 @@ static struct builtin_term builtin_termcaps[] =
     {(int)KS_CRT,	IF_EB("\033[23;2t", ESC_STR "[23;2t")},
     {(int)KS_SSI,	IF_EB("\033[22;1t", ESC_STR "[22;1t")},
     {(int)KS_SRI,	IF_EB("\033[23;1t", ESC_STR "[23;1t")},
+    {(int)KS_BSU,	IF_EB("\033[?2026h", ESC_STR "[?2026h")},
+    {(int)KS_ESU,	IF_EB("\033[?2026l", ESC_STR "[?2026l")},
 
     {K_UP,		IF_EB("\033O*A", ESC_STR "O*A")},
     {K_DOWN,		IF_EB("\033O*B", ESC_STR "O*B")},
@@ -2575,35 +2578,259 @@ termcapinit(char_u *name)
 
 /*
  * The number of calls to ui_write is reduced by using "out_buf".
+ * While redrawing the screen with update_screen() "out_buf" grows, up to
+ * OUT_MAX_SIZE, and out_flush() does nothing, so that the whole redraw is
+ * written at once.  When 't_BS' and 't_ES' are set this is wrapped in a
+ * synchronized update, so that the terminal shows it all at once.
  */
 #define OUT_SIZE	2047
+#define OUT_MAX_SIZE	(1024 * 1024)
 
 // add one to allow mch_write() in os_win32.c to append a NUL
-static char_u		out_buf[OUT_SIZE + 1];
+static char_u		out_buf_init[OUT_SIZE + 1];
+static char_u		*out_buf = out_buf_init;
+static int		out_size = OUT_SIZE;	// size of out_buf, not counting
+						// the extra byte for a NUL
 
 static int		out_pos = 0;	// number of chars in out_buf
 
+static int		out_redraw = FALSE;	// TRUE while redrawing
+static int		out_redraw_pos;		// out_pos when the redraw
+						// started
+static long		out_redraw_written;	// bytes written while redrawing
+static long		out_redraw_writes;	// writes while redrawing
+static int		out_sync_started = FALSE; // 't_BS' was put in out_buf
+static int		out_sync_end = FALSE;	// put 't_ES' before writing
+
+// Counters, see redraw_stats().
+static long		out_total_bytes = 0;
+static long		out_total_writes = 0;
+static long		out_last_bytes = 0;	// bytes of the last redraw
+static long		out_last_writes = 0;	// writes for the last redraw
+static long		out_redraw_count = 0;	// nr of redraws with output
+
 // Since the maximum number of SGR parameters shown as a normal value range is
 // 16, the escape sequence length can be 4 * 16 + lead + tail.
 #define MAX_ESC_SEQ_LEN	80
 
+/*
+ * Return TRUE when the output is collected for a redraw.  Not when
+ * 'writedelay' is set, it is used to see what is being drawn, and not for
+ * the GUI, which draws directly.
+ */
+    static int
+out_collecting(void)
+{
+    return out_redraw && !p_wd
+#ifdef FEAT_GUI
+	&& !gui.in_use
+#endif
+	;
+}
+
+/*
+ * Make out_buf[] bigger, so that at least "len" more bytes fit.
+ * Returns FAIL when it can't grow.
+ */
+    static int
+out_buf_grow(int len)
+{
+    int		size = out_size;
+    char_u	*p;
+
+    while (size < out_pos + len)
+	size = size * 2 + 1;
+    if (size > OUT_MAX_SIZE)
+	return FAIL;
+    p = alloc(size + 1);
+    if (p == NULL)
+	return FAIL;
+    mch_memmove(p, out_buf, (size_t)out_pos);
+    if (out_buf != out_buf_init)
+	vim_free(out_buf);
+    out_buf = p;
+    out_size = size;
+    return OK;
+}
+
+/*
+ * Insert string "s" in out_buf[] at "pos".  Used for the synchronized update
+ * codes, the caller checks that out_buf[] is big enough.
+ */
+    static void
+out_buf_insert(int pos, char_u *s)
+{
+    int		len = (int)STRLEN(s);
+
+    mch_memmove(out_buf + pos + len, out_buf + pos, (size_t)(out_pos - pos));
+    mch_memmove(out_buf + pos, s, (size_t)len);
+    out_pos += len;
+}
+
+/*
+ * Make room for "len" bytes in out_buf[].  While redrawing out_buf[] grows,
+ * otherwise, or when it is too big already, it is flushed.
+ */
+    static void
+out_buf_room(int len)
+{
+    if (out_pos + len <= out_size)
+	return;
+    if (!out_collecting() || out_buf_grow(len) == FAIL)
+	out_flush_now();
+}
+
+/*
+ * Write out_buf[], also while redrawing.
+ */
+    static void
+out_flush_now(void)
+{
+    int	    len;
+    int	    sync_len;
+
+    if (out_pos == 0 && !out_sync_end)
+	return;
+
+    if (out_collecting() && !out_sync_started && *T_BSU != NUL && *T_ESU != NUL)
+    {
+	// Flushing in the middle of a redraw, start the synchronized update
+	// now.
+	sync_len = (int)STRLEN(T_BSU);
+	if (out_pos + sync_len <= out_size || out_buf_grow(sync_len) == OK)
+	{
+	    out_buf_insert(0, T_BSU);
+	    out_sync_started = TRUE;
+	}
+    }
+    if (out_sync_end)
+    {
+	sync_len = (int)STRLEN(T_ESU);
+	if (out_pos + sync_len <= out_size || out_buf_grow(sync_len) == OK)
+	    out_buf_insert(out_pos, T_ESU);
+	out_sync_end = FALSE;
+	out_sync_started = FALSE;
+    }
+
+    // set out_pos to 0 before ui_write, to avoid recursiveness
+    len = out_pos;
+    out_pos = 0;
+    if (out_redraw)
+    {
+	out_redraw_written += len - out_redraw_pos;
+	++out_redraw_writes;
+	out_redraw_pos = 0;
+    }
+    out_total_bytes += len;
+    ++out_total_writes;
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+	redraw_time_start(RDT_OUT_FLUSH);
+#endif
+    ui_write(out_buf, len);
+#ifdef FEAT_PROFILE
+    if (redraw_time_on)
+	redraw_time_end(RDT_OUT_FLUSH);
+#endif
+}
+
 /*
  * out_flush(): flush the output buffer
+ * While redrawing this does nothing, see out_redraw_start().
  */
     void
 out_flush(void)
 {
-    int	    len;
+    if (!out_collecting())
+	out_flush_now();
+}
+
+/*
+ * Write the output collected for a redraw so far.  Used before waiting, so
+ * that it shows up.
+ */
+    void
+out_flush_collected(void)
+{
+    if (out_collecting())
+	out_flush_now();
+}
+
+/*
+ * Called by update_screen() when starting to redraw: collect the output
+ * until out_redraw_end() is called.
+ */
+    void
+out_redraw_start(void)
+{
+    out_redraw = TRUE;
+    out_redraw_pos = out_pos;
+    out_redraw_written = 0;
+    out_redraw_writes = 0;
+}
+
+/*
+ * Called by update_screen() when done redrawing.  Ends the synchronized
+ * update and updates the counters.  The output is not written yet, so that
+ * positioning the cursor is included.
+ */
+    void
+out_redraw_end(void)
+{
+    long    bytes;
 
-    if (out_pos != 0)
+    if (!out_redraw)
+	return;
+    if (out_collecting() && *T_BSU != NUL && *T_ESU != NUL
+	    && !out_sync_started && out_pos > out_redraw_pos
+	    && (out_pos + (int)STRLEN(T_BSU) <= out_size
+				  || out_buf_grow((int)STRLEN(T_BSU)) == OK))
+    {
+	out_buf_insert(out_redraw_pos, T_BSU);
+	out_sync_started = TRUE;
+    }
+    bytes = out_redraw_written + out_pos - out_redraw_pos;
+    if (out_sync_started)
     {
-	/* set out_pos to 0 before ui_write, to avoid recursiveness */
-	len = out_pos;
-	out_pos = 0;
-	ui_write(out_buf, len);
+	out_sync_end = TRUE;
+	bytes += (long)STRLEN(T_ESU);
     }
+    if (bytes > 0)
+    {
+	out_last_bytes = bytes;
+	out_last_writes = out_redraw_writes + (out_pos > 0 ? 1 : 0);
+	++out_redraw_count;
+    }
+    out_redraw = FALSE;
 }
 
+#if defined(FEAT_EVAL) || defined(PROTO)
+/*
+ * Add the output counters to dictionary "d", for redraw_stats().
+ */
+    void
+out_add_stats(dict_T *d)
+{
+    dict_add_number(d, "redraws", out_redraw_count);
+    dict_add_number(d, "bytes", out_last_bytes);
+    dict_add_number(d, "writes", out_last_writes);
+    dict_add_number(d, "total_bytes", out_total_bytes);
+    dict_add_number(d, "total_writes", out_total_writes);
+}
+#endif
+
+#if defined(EXITFREE) || defined(PROTO)
+    void
+free_out_buf(void)
+{
+    out_pos = 0;
+    if (out_buf != out_buf_init)
+	vim_free(out_buf);
+    out_buf = out_buf_init;
+    out_size = OUT_SIZE;
+}
+#endif
+
 /*
  * out_flush_cursor(): flush the output buffer and redraw the cursor.
  * Does not flush recursively in the GUI to avoid slow drawing.
@@ -2633,8 +2860,8 @@ out_flush_cursor(
     void
 out_flush_check(void)
 {
-    if (enc_dbcs != 0 && out_pos >= OUT_SIZE - MB_MAXBYTES)
-	out_flush();
+    if (enc_dbcs != 0)
+	out_buf_room(MB_MAXBYTES);
 }
 
 #ifdef FEAT_GUI
@@ -2665,8 +2892,10 @@ out_char(unsigned c)
     out_buf[out_pos++] = c;
 
     /* For testing we flush each time. */
-    if (out_pos >= OUT_SIZE || p_wd)
+    if (p_wd)
 	out_flush();
+    else
+	out_buf_room(1);
 }
 
 static void out_char_nf(unsigned);
@@ -2684,8 +2913,7 @@ out_char_nf(unsigned c)
 
     out_buf[out_pos++] = c;
 
-    if (out_pos >= OUT_SIZE)
-	out_flush();
+    out_buf_room(1);
 }
 
 #if defined(FEAT_TITLE) || defined(FEAT_MOUSE_TTY) || defined(FEAT_GUI) \
@@ -2703,8 +2931,7 @@ out_char_nf(unsigned c)
 out_str_nf(char_u *s)
 {
     // avoid terminal strings being split up
-    if (out_pos > OUT_SIZE - MAX_ESC_SEQ_LEN)
-	out_flush();
+    out_buf_room(MAX_ESC_SEQ_LEN);
 
     while (*s)
 	out_char_nf(*s++);
@@ -2738,8 +2965,7 @@ out_str_cf(char_u *s)
 	    return;
 	}
 #endif
-	if (out_pos > OUT_SIZE - MAX_ESC_SEQ_LEN)
-	    out_flush();
+	out_buf_room(MAX_ESC_SEQ_LEN);
 #ifdef HAVE_TGETENT
 	for (p = s; *s; ++s)
 	{
@@ -2806,8 +3032,7 @@ out_str(char_u *s)
 	}
 #endif
 	/* avoid terminal strings being split up */
-	if (out_pos > OUT_SIZE - MAX_ESC_SEQ_LEN)
-	    out_flush();
+	out_buf_room(MAX_ESC_SEQ_LEN);
 #ifdef HAVE_TGETENT
 	tputs((char *)s, 1, TPUTSFUNCAST out_char_nf);
 #else
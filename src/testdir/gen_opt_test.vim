@@ -38,7 +38,7 @@ let test_values = {
       \ 'lines': [[2, 24], [-1, 0, 1]],
       \ 'linespace': [[0, 2, 4], ['']],
       \ 'numberwidth': [[1, 4, 8, 10, 11, 20], [-1, 0, 21]],
-      \ 'regexpengine': [[0, 1, 2], [-1, 3, 999]],
+      \ 'regexpengine': [[0, 1, 2, 3], [-1, 4, 999]],
       \ 'report': [[0, 1, 2, 9999], [-1]],
       \ 'scroll': [[0, 1, 2, 20], [-1]],
       \ 'scrolljump': [[-50, -1, 0, 1, 2, 20], [999]],
@@ -170,3 +170,23 @@ func Test_appendbufline_redraw()
   call StopVimInTerminal(buf)
   call delete('XscriptMatchCommon')
 endfunc
+
+func Test_appendbufline_many()
+  new
+  let b = bufnr('%')
+  call setline(1, ['first', 'last'])
+  hide
+  let lines = map(range(1, 3000), '"line " .. v:val')
+  call assert_equal(0, appendbufline(b, 1, lines))
+  call assert_equal(['first'] + lines + ['last'], getbufline(b, 1, '$'))
+
+  " Numbers and strings mixed.
+  call assert_equal(0, appendbufline(b, '$', ['a', 12, 'b', 34, 'c']))
+  call assert_equal(['last', 'a', '12', 'b', '34', 'c'],
+	\ getbufline(b, 3002, '$'))
+
+  " setbufline() replaces existing lines and appends the rest.
+  call assert_equal(0, setbufline(b, 3005, lines[:99]))
+  call assert_equal(['a', '12'] + lines[:99], getbufline(b, 3003, '$'))
+  exe 'bwipe! ' .. b
+endfunc
@@ -1546,6 +1546,20 @@ func Test_collapse_buffers()
   bwipe!
 endfunc
 
+func Test_many_lines_to_buffer()
+  CheckExecutable cat
+
+  let lines = map(range(1, 20000), '"line " .. v:val')
+  call writefile(lines, 'Xmanylines')
+  split testout
+  1,$delete
+  call job_start('cat Xmanylines', {'out_io': 'buffer', 'out_name': 'testout'})
+  call WaitForAssert({-> assert_equal(20000, line('$'))})
+  call assert_equal(lines, getline(1, '$'))
+  bwipe!
+  call delete('Xmanylines')
+endfunc
+
 func Test_write_to_deleted_buffer()
   CheckExecutable echo
 
@@ -103,3 +103,65 @@ func Test_scroll_without_region()
   call StopVimInTerminal(buf)
   call delete('Xtestscroll')
 endfunc
+
+func Test_redraw_stats()
+  CheckNotGui
+  let save_bs = &t_BS
+  let save_es = &t_ES
+  new
+  call setline(1, range(1, 100))
+
+  set t_BS= t_ES=
+  redraw!
+  let before = redraw_stats()
+  redraw!
+  let stats = redraw_stats()
+  call assert_equal(before.redraws + 1, stats.redraws)
+  call assert_inrange(1, 10000, stats.bytes)
+  " the whole redraw is written at once
+  call assert_equal(1, stats.writes)
+  call assert_equal(before.total_writes + 1, stats.total_writes)
+  call assert_equal(before.total_bytes + stats.bytes, stats.total_bytes)
+
+  " with synchronized update codes these are added
+  let &t_BS = "\<Esc>[?2026h"
+  let &t_ES = "\<Esc>[?2026l"
+  redraw!
+  let sync_stats = redraw_stats()
+  call assert_equal(stats.bytes + 16, sync_stats.bytes)
+  call assert_equal(1, sync_stats.writes)
+
+  let &t_BS = save_bs
+  let &t_ES = save_es
+  bwipe!
+endfunc
+
+func Test_redraw_stats_time()
+  CheckNotGui
+  CheckFeature profile
+  CheckFeature float
+  new
+  call setline(1, range(1, 20))
+  call redraw_stats('on')
+  redraw!
+  let stats = redraw_stats()
+  call assert_equal(1, stats.timing)
+  call assert_equal(['out_flush', 'screen_line', 'syntax', 'textprop',
+	\ 'update_screen', 'win_line', 'win_update'], sort(keys(stats.time)))
+  call assert_equal(1, stats.time.update_screen.last_count)
+  call assert_equal(1, stats.time.update_screen.count)
+  call assert_inrange(10, 100, stats.time.win_line.last_count)
+  " times are inclusive
+  call assert_true(stats.time.update_screen.last >= stats.time.win_update.last)
+  call assert_true(stats.time.win_update.last >= stats.time.win_line.last)
+
+  call redraw_stats('off')
+  redraw!
+  let stats = redraw_stats()
+  call assert_equal(0, stats.timing)
+  call assert_equal(1, stats.time.update_screen.count)
+  call redraw_stats('clear')
+  call assert_equal(0, redraw_stats().time.update_screen.count)
+  call assert_fails("call redraw_stats('xxx')", 'E475:')
+  bwipe!
+endfunc
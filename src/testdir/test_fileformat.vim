@@ -276,3 +276,30 @@ func Test_fileformats()
   call delete('XXUxDsMc')
   call delete('Xtest')
 endfunc
+
+" Test reading a file larger than the read buffer, with a retry for another
+" 'fileencoding' and 'fileformat'.
+func Test_read_large_file()
+  let lines = map(range(1, 60000), '"line " .. v:val .. " " .. repeat("x", v:val % 40)')
+  call writefile(map(copy(lines), 'v:val .. "\r"'), 'Xlarge')
+  call assert_true(getfsize('Xlarge') > 1024 * 1024)
+  set fileformats=unix,dos fileencodings=utf-8,latin1
+  e! Xlarge
+  call assert_equal('dos', &fileformat)
+  call assert_equal(60000, line('$'))
+  call assert_equal(lines, getline(1, '$'))
+  bwipe!
+
+  " An illegal byte in the last line causes the file to be read again.
+  call writefile(lines + ["caf\xe9"], 'Xlarge')
+  e! Xlarge
+  call assert_equal('unix', &fileformat)
+  call assert_equal('latin1', &fileencoding)
+  call assert_equal(60001, line('$'))
+  call assert_equal(lines, getline(1, 60000))
+  call assert_equal("café", getline('$'))
+  bwipe!
+
+  set fileformats& fileencodings&
+  call delete('Xlarge')
+endfunc
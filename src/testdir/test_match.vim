@@ -303,5 +303,52 @@ func Test_matchadd_other_window()
   call delete('XscriptMatchCommon')
 endfunc
 
+func Test_matchadd_many_literals()
+  syntax on
+  new
+  call setline(1, ['foo bar foobar', 'hers she his', 'nothing', 'abcabc',
+        \ 'bx box zz', 'word swords'])
+  " Literals that share a prefix or are a suffix of another one, and patterns
+  " that start with literal text.
+  let ids = {}
+  for pat in ['foo', 'bar', 'obar', 'he', 'she', 'hers', 'his', 'cab', 'bar',
+        \ 'bo*x', 'xy\|zz', '\<word\>']
+    let ids[pat] = matchadd('Error', pat)
+  endfor
+  call matchadd('Search', 'noth.ng')
+  redraw!
+  let normal = screenattr(1, 4)
+  let error = screenattr(1, 1)
+  let search = screenattr(3, 1)
+  call assert_notequal(normal, error)
+  call assert_notequal(normal, search)
+  call assert_notequal(error, search)
+
+  let expected = ['eeeneeeneeeeee', 'eeeeneeeneee', 'sssssss', 'nneeen',
+        \ 'eeneeenee', 'eeeennnnnnn']
+  for lnum in range(1, len(expected))
+    for col in range(1, len(expected[lnum - 1]))
+      let attr = {'n': normal, 'e': error, 's': search}[expected[lnum - 1][col - 1]]
+      call assert_equal(attr, screenattr(lnum, col), 'line ' .. lnum .. ' col ' .. col)
+    endfor
+  endfor
+
+  " A literal with a higher priority wins.
+  call matchadd('Search', 'bar', 20)
+  redraw!
+  call assert_equal(search, screenattr(1, 5))
+  call assert_equal(search, screenattr(1, 12))
+  call assert_equal(error, screenattr(1, 9))
+
+  call matchdelete(ids['cab'])
+  redraw!
+  call assert_equal(normal, screenattr(4, 4))
+
+  call clearmatches()
+  redraw!
+  call assert_equal(normal, screenattr(1, 1))
+  bwipe!
+  syntax off
+endfunc
 
 " vim: shiftwidth=2 sts=2 expandtab
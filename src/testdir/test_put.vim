@@ -44,6 +44,28 @@ func Test_put_lines()
   eval a[0]->setreg('a', a[1])
 endfunc
 
+func Test_put_many_lines()
+  new
+  let a = [ getreg('a'), getregtype('a') ]
+  let lines = map(range(1, 2000), '"line " .. v:val .. repeat("x", 20)')
+  call setline(1, ['first', 'second', 'third'])
+  call setreg('a', lines, 'l')
+  let &undolevels = &undolevels
+  2put a
+  call assert_equal(['first', 'second'] + lines + ['third'], getline(1, '$'))
+  call assert_equal(2002, line('.'))
+  undo
+  call assert_equal(['first', 'second', 'third'], getline(1, '$'))
+
+  " characterwise register with many lines, put with a count
+  call setreg('a', ['<'] + lines + ['>'], 'c')
+  normal! gg0"a2p
+  call assert_equal(['f<'] + lines + ['><'] + lines
+	\ + ['>irst', 'second', 'third'], getline(1, '$'))
+  bw!
+  eval a[0]->setreg('a', a[1])
+endfunc
+
 func Test_put_expr()
   new
   call setline(1, repeat(['A'], 6))
@@ -2,6 +2,8 @@
 set encoding=latin1
 scriptencoding latin1
 
+source check.vim
+
 func s:equivalence_test()
   let str = "A B C D E F G H I J K L M N O P Q R S T U V W X Y Z a b c d e f g h i j k l m n o p q r s t u v w x y z"
   let groups = split(str)
@@ -141,3 +143,96 @@ func Test_pattern_compile_speed()
   call assert_inrange(0.01, 10.0, reltimefloat(reltime(start)))
   set spc=
 endfunc
+
+func Test_regexp_cache()
+  let before = regexp_stats()
+  for i in range(10)
+    call assert_equal('bar', matchstr('foo bar', 'b\w\+'))
+  endfor
+  let after = regexp_stats()
+  call assert_true(after.cache_hits >= before.cache_hits + 9)
+  call assert_inrange(1, after.cache_size, after.cache_entries)
+
+  " 'ignorecase' is used when matching, not when compiling
+  set ignorecase
+  call assert_equal('Bar', matchstr('foo Bar', 'b\w\+'))
+  set noignorecase
+  call assert_equal('', matchstr('foo Bar', 'b\w\+'))
+
+  " 'magic' and the engine are part of the key
+  new
+  call setline(1, 'abc b.')
+  call assert_equal([1, 2], searchpos('b.', 'cnw'))
+  set nomagic
+  call assert_equal([1, 5], searchpos('b.', 'cnw'))
+  set magic
+  call assert_equal([1, 2], searchpos('\%#=1b.', 'cnw'))
+  call assert_equal([1, 2], searchpos('\%#=2b.', 'cnw'))
+
+  " using the same pattern recursively
+  call setline(1, 'one two')
+  s/\w\+/\=matchstr(submatch(0), '\w\+') . '!'/g
+  call assert_equal('one! two!', getline(1))
+  s/\w\+/\=substitute(submatch(0), '\w\+', 'x', '')/g
+  call assert_equal('x! x!', getline(1))
+
+  " a syntax item using the same pattern while :s evaluates "\=",
+  " afterwards the cached program can still be used
+  call setline(1, ['foo foo', 'x foo'])
+  syn match Comment /fo\+/
+  s/fo\+/\=synID(2, 3, 1) == hlID('Comment') ? 'ok' : 'fail'/g
+  call assert_equal('ok ok', getline(1))
+  let before = regexp_stats()
+  call assert_equal(2, search('fo\+', 'nw'))
+  call assert_equal(before.cache_hits + 1, regexp_stats().cache_hits)
+  syn clear
+  bwipe!
+
+  " a pattern with an error is not cached
+  call assert_fails("call match('x', '\\%#=9x')", 'E864:')
+  call assert_fails("call match('x', '\\%#=9x')", 'E864:')
+endfunc
+
+func Test_regexp_adaptive_engine()
+  CheckFeature reltime
+  set re=0
+  let before = regexp_stats()
+  " timing continues until enough time was measured, at most 2000 times
+  let lines = map(range(2100), {i, v -> 'line ' .. v .. ' foo' .. v .. 'bar'})
+  let pat = '\<foo\d\+bar\>'
+  call assert_equal(2100, len(filter(copy(lines), {i, v -> v =~ pat})))
+  call assert_equal(['foo42bar'], matchlist(lines[42], pat)[:0])
+  call assert_equal(0, len(filter(copy(lines), {i, v -> v =~ pat .. 'x'})))
+  " after being timed with both engines one of them was chosen for each
+  " pattern
+  let after = regexp_stats()
+  call assert_equal(before.adapt_nfa + before.adapt_backtracking + 2,
+        \ after.adapt_nfa + after.adapt_backtracking)
+
+  " backtracking is not used for a pattern when it takes very long or fails
+  " because of 'maxmempattern', without an error message
+  let before = regexp_stats()
+  for i in range(40)
+    call assert_equal(-1, match(repeat('a', 34), '\v^(a|aa)*b'))
+  endfor
+  set maxmempattern=1
+  let v:errmsg = ''
+  for i in range(40)
+    call assert_equal(-1, match(repeat('a', 5000), '\(a\)*\d'))
+  endfor
+  call assert_equal('', v:errmsg)
+  set maxmempattern&
+  let after = regexp_stats()
+  call assert_equal(before.adapt_nfa + 2, after.adapt_nfa)
+  set re&
+endfunc
+
+func Test_regexp_nfa_list_reuse()
+  let before = regexp_stats()
+  let lines = map(range(50), {i, v -> 'abc' .. v .. 'def'})
+  call assert_equal(50, len(filter(copy(lines), {i, v -> v =~ '\%#=2c\d\+d'})))
+  " the lists of states are allocated once and then reused for each line
+  let after = regexp_stats()
+  call assert_inrange(0, 4, after.nfa_list_allocs - before.nfa_list_allocs)
+  call assert_true(after.nfa_list_reuses - before.nfa_list_reuses >= 90)
+endfunc
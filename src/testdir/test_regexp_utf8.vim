@@ -215,3 +215,86 @@ func Test_optmatch_toolong()
   set re=0
 endfunc
 
+
+" Skipping ahead to the start character or literal text of a pattern, also
+" after multi-byte characters and at every alignment of a long line.
+func Test_skip_to_start_literal()
+  for re in range(0, 2)
+    exe 'set re=' . re
+    for n in range(0, 20)
+      let text = repeat('x', n) .. 'ä€' .. repeat('y', n) .. 'MatchThis'
+      let col = n * 2 + 5
+      call assert_equal(col, match(text, '\CMatchThis'))
+      call assert_equal(col, match(text, '\cmatchthis'))
+      call assert_equal(col, match(text, '\cM\w*This'))
+      call assert_equal(-1, match(text, '\Cmatchthis'))
+      call assert_equal(col + 1, match(text, '\Catch'))
+      call assert_equal(-1, match(text . 'nothing', '\cnotfound'))
+      " a composing character after the literal text is not a match
+      call assert_equal(-1, match(text .. "́", '\CMatchThis\%$'))
+      call assert_equal(n + 2, match(text, '€y*M'))
+      call assert_equal(n + 2, match(text, '\c€Y*m'))
+    endfor
+    call assert_equal(['abXab'], matchlist('xaabXab', '\Cab.ab')[:0])
+    call assert_equal(-1, match("ABC\nabc", '\Cbcd'))
+    call assert_equal(5, match("ABC\nabc", '\Cbc'))
+  endfor
+  set re=0
+endfunc
+
+" The NFA engine with the DFA must give the same results as without it.
+func Test_dfa_engine()
+  let pats = ['\(foo\|bar\|baz\)\d\+', 'a\+b', '^abc', 'abc$', '^$', '^',
+	\ '$', 'x*', '[a-c]\+z', '[^a-z]\{3}', '\cFOO', '\CFoo', '\w\+@\w\+',
+	\ '\s\+$', '^\s*#', '[[:upper:]][[:lower:]]\+', '\%(ab\)\+c', '\zsfoo',
+	\ 'foo\zebar', 'ä\+', '[ä-ü]', '.', '\d\d:\d\d', '\(a\|b\)*c',
+	\ '\v(cat|dog)s?', '\v^(a|b)+$', '\a\A', '[[:alpha:][:digit:]]x',
+	\ '\x\x', '\o\O', '\h\H', '\l\L', '\u\U', 'é', 'e\%C', '\<dog\>']
+  let texts = ['', 'foo12 bar', 'baz', 'xxfoo9', 'aab', 'abc', 'xabc',
+	\ 'abcx', 'ABC', 'hello world  ', '  # comment', 'Hello World', 'ababc',
+	\ 'foobar', 'äää', 'üx', 'Fööbar', '12:34', 'aabbc', 'cats', 'dogs',
+	\ 'abab', 'a1', 'FOO', "e\u0301x", "x\u0301", 'ÄBC', 'a@b', 'dog',
+	\ '0x1F', 'eé', 'a dog']
+  for ic in [0, 1]
+    let &ignorecase = ic
+    for pat in pats
+      for text in texts
+	for col in [0, 1]
+	  let expected = [match(text, '\%#=2' .. pat, col),
+		\ matchend(text, '\%#=2' .. pat, col)]
+	  call assert_equal(expected, [match(text, '\%#=3' .. pat, col),
+		\ matchend(text, '\%#=3' .. pat, col)],
+		\ printf('ic=%d %s %s %d', ic, pat, text, col))
+	endfor
+      endfor
+    endfor
+  endfor
+  set ignorecase&
+
+  " In a buffer, most lines don't match.
+  new
+  call setline(1, map(range(1, 1000), '"line " .. v:val'))
+  call setline(700, 'a bar42 here')
+  set re=3
+  call assert_equal(700, search('\(foo\|bar\|baz\)\d\+'))
+  call assert_equal([0, 700, 3, 0], getpos('.'))
+  %s/\v(line) (\d+)5$/\2\1/
+  call assert_equal('99line', getline(995))
+  call assert_equal('line 996', getline(996))
+  set re&
+  bwipe!
+
+  call assert_fails('call match("abc", "\\%#=4abc")', 'E864:')
+
+  " [:print:] depends on 'isprint', the DFA of a syntax item must not
+  " remember it.
+  new
+  call setline(1, "x\x7f")
+  syn match Comment /\%#=3[[:print:]]\{2}/
+  set isprint=@
+  call assert_equal(0, synID(1, 1, 1))
+  set isprint=@,127
+  call assert_equal(hlID('Comment'), synID(1, 1, 1))
+  set isprint&
+  bwipe!
+endfunc
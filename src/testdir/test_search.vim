@@ -1353,3 +1353,76 @@ func Test_searchdecl()
 
   bwipe!
 endfunc
+
+" Return the columns where backward searching for "pat" in the current line
+" stops, starting at the end of the line.
+func s:search_back_cols(pat)
+  let cols = []
+  normal! $
+  while search(a:pat, 'bW', line('.')) > 0
+    call add(cols, col('.') - 1)
+  endwhile
+  return cols
+endfunc
+
+" Return the columns of the matches of "pat" in "line" before the last
+" character, like a backward search finds them.
+func s:match_cols(line, pat)
+  let cols = []
+  let start = 0
+  while 1
+    let [str, s, e] = matchstrpos(a:line, a:pat, start)
+    if s < 0 || s >= len(a:line) - 1
+      break
+    endif
+    call insert(cols, s)
+    let start = &cpo =~ 'c' && e > s ? e : s + 1
+  endwhile
+  return cols
+endfunc
+
+func Test_search_backward_long_line()
+  let save_cpo = &cpo
+  new
+  let line = repeat('xaaay foo ab fooab Foo ', 100)
+  call setline(1, line)
+  for cpo in ['', 'c']
+    let &cpo = cpo
+    " literal text, text that may overlap and other patterns
+    for pat in ['foo', 'fooab', 'aa', 'a', 'ab\w*', '\<f', 'o\zsf', 'y\|b']
+      call assert_equal(s:match_cols(line, pat), s:search_back_cols(pat),
+            \ pat .. ' with cpo=' .. cpo)
+    endfor
+  endfor
+  let &cpo = save_cpo
+
+  " the end of the match
+  call setline(1, 'xaaay foo ab fooab fooab x')
+  normal! $
+  call assert_equal([1, 24], searchpos('fooab', 'bWe'))
+  call assert_equal([1, 18], searchpos('fooab', 'bWe'))
+  call assert_equal([1, 12], searchpos('ab', 'bWe'))
+  call assert_equal([1, 9], searchpos('o', 'bWe'))
+  call assert_equal([1, 4], searchpos('a\+', 'bWe'))
+
+  " changing the text or 'ignorecase' finds other matches
+  call setline(1, line)
+  call assert_equal(s:match_cols(line, 'f\w\w'), s:search_back_cols('f\w\w'))
+  let line = repeat('foox ', 100)
+  call setline(1, line)
+  call assert_equal(s:match_cols(line, 'f\w\w'), s:search_back_cols('f\w\w'))
+  call setline(1, repeat('Foo foo ', 10))
+  set ignorecase
+  call assert_equal(range(76, 0, -4), s:search_back_cols('f\w\w'))
+  call assert_equal(range(76, 0, -4), s:search_back_cols('foo'))
+  set noignorecase
+  call assert_equal(range(76, 4, -8), s:search_back_cols('f\w\w'))
+  call assert_equal(range(76, 4, -8), s:search_back_cols('foo'))
+
+  " a pattern using the cursor position
+  call setline(1, 'ab ab ab')
+  normal! $
+  call assert_equal([1, 7], searchpos('\%#.\|ab', 'bW'))
+  call assert_equal([1, 4], searchpos('\%#.\|ab', 'bW'))
+  bwipe!
+endfunc
@@ -368,3 +368,101 @@ func Test_statusline()
   set laststatus&
   set splitbelow&
 endfunc
+
+" Get the status line without redrawing.
+func s:get_statusline_now()
+  return join(map(range(1, &columns), 'screenstring(&lines - 1, v:val)'), '')
+endfunc
+
+func StatuslineCount()
+  let g:stl_count += 1
+  return 'count' .. g:stl_count
+endfunc
+
+func StatuslineCached()
+  let g:stl_cached += 1
+  return 'cached' .. g:stl_cached
+endfunc
+
+func Test_statusline_cache_hint()
+  set laststatus=2
+  call setline(1, ['one', 'two', 'three'])
+  split
+  let g:stl_count = 0
+  let g:stl_cached = 0
+  set statusline=%{StatuslineCount()}%{=b:StatuslineCached()}
+  redraw
+  call assert_equal(2, g:stl_count)
+  call assert_equal(2, g:stl_cached)
+  call assert_match('^count2cached2 ', s:get_statusline_now())
+
+  " going to another window redraws the status lines, the cached item is not
+  " evaluated
+  wincmd w
+  redraw
+  call assert_equal(4, g:stl_count)
+  call assert_equal(2, g:stl_cached)
+
+  " changing the buffer does evaluate it
+  call setline(1, 'changed')
+  wincmd w
+  redraw
+  call assert_equal(6, g:stl_count)
+  call assert_equal(4, g:stl_cached)
+
+  " with "w" a window size change evaluates it
+  set statusline=%{=w:StatuslineCached()}
+  redraw
+  call assert_equal(6, g:stl_cached)
+  resize -1
+  redraw
+  call assert_equal(8, g:stl_cached)
+
+  " :redrawstatus! evaluates all items
+  redrawstatus!
+  call assert_equal(10, g:stl_cached)
+
+  " without valid flags it's an expression
+  set statusline=%{=x:StatuslineCached()}
+  call assert_fails('redraw', 'E15:')
+
+  only
+  set statusline&
+  set laststatus&
+  bwipe!
+endfunc
+
+func Test_statuslinecache()
+  set laststatus=2
+  call setline(1, ['one', 'two', 'three'])
+  let g:stl_count = 0
+  set statusline=%{StatuslineCount()}
+  redraw
+  call assert_equal(1, g:stl_count)
+  " changing highlighting redraws the status line
+  hi StatusLine cterm=bold
+  redraw
+  call assert_equal(2, g:stl_count)
+
+  set statuslinecache
+  redraw
+  call assert_equal(3, g:stl_count)
+  hi StatusLine cterm=reverse
+  redraw
+  call assert_equal(3, g:stl_count)
+  call assert_match('^count3 ', s:get_statusline_now())
+
+  " moving the cursor evaluates it again
+  2
+  hi StatusLine cterm=bold
+  redraw
+  call assert_equal(4, g:stl_count)
+  call assert_match('^count4 ', s:get_statusline_now())
+
+  redrawstatus
+  call assert_equal(5, g:stl_count)
+
+  hi StatusLine cterm=reverse,bold
+  set statuslinecache& statusline& laststatus&
+  bwipe!
+endfunc
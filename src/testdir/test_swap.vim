@@ -304,3 +304,143 @@ func Test_swap_recover_ext()
   augroup END
   augroup! test_swap_recover_ext
 endfunc
+
+" Test memfile_stats() and that blocks used repeatedly stay in memory when
+" going over all lines.
+func Test_memfile_stats()
+  call assert_equal({}, memfile_stats(9999))
+
+  set maxmem=1 directory=.
+  new Xmemfile
+  call setline(1, map(range(1, 20000), '"line " .. v:val .. repeat("x", 50)'))
+  let stats = memfile_stats()
+  call assert_true(stats.swapfile)
+  call assert_equal(10, stats.max_pages)
+  call assert_true(stats.used_pages <= stats.max_pages + 1)
+  call assert_true(stats.evictions > 0)
+  call assert_true(stats.writes > 0)
+  call assert_equal(stats, bufnr()->memfile_stats())
+
+  " Lines near the top are used over and over while going over the whole
+  " buffer, the blocks for them become hot.
+  for round in range(3)
+    for lnum in range(1, 20000, 100)
+      let text = getline(lnum)
+      let text = getline(1)
+    endfor
+  endfor
+  let stats = memfile_stats()
+  call assert_true(stats.misses > 0)
+  call assert_equal(stats.misses, stats.reads)
+  call assert_true(stats.ghost_hits > 0)
+  call assert_true(stats.probation_pages < stats.used_pages)
+
+  " The block of the first line is found in memory after a scan.
+  for lnum in range(1, 20000, 100)
+    let text = getline(lnum)
+  endfor
+  let misses = memfile_stats().misses
+  let text = getline(1)
+  call assert_equal(misses, memfile_stats().misses)
+
+  bwipe!
+  set maxmem& directory&
+endfunc
+
+func Test_swap_coalesced_writes()
+  set directory=.
+  new Xcoalesce
+  let lines = map(range(1, 2000), '"line " .. v:val .. repeat("x", 50)')
+  call setline(1, lines)
+  preserve
+  let writes = memfile_stats().writes
+
+  " Changing all the lines makes all data blocks dirty, they are next to
+  " each other in the swap file and are written together.
+  %s/line/LINE/
+  preserve
+  call assert_inrange(1, 3, memfile_stats().writes - writes)
+
+  let swapfile_name = swapname('%')
+  let swapfile_bytes = readfile(swapfile_name, 'B')
+  bwipe!
+  call writefile(swapfile_bytes, swapfile_name)
+  new
+  exe 'recover ' .. swapfile_name
+  call assert_equal(map(lines, 'substitute(v:val, "line", "LINE", "")'),
+	\ getline(1, '$'))
+  bwipe!
+  call delete(swapfile_name)
+  set directory&
+endfunc
+
+func Test_memline_block_cache()
+  new
+  call setline(1, map(range(1, 5000), '"line " .. v:val'))
+  let stats = memfile_stats()
+  for round in range(10)
+    call assert_equal('line 10', getline(10))
+    call assert_equal('line 4000', getline(4000))
+  endfor
+  let stats2 = memfile_stats()
+  call assert_equal(stats.line_lookups + 20, stats2.line_lookups)
+  call assert_inrange(18, 20,
+	\ stats2.block_cache_hits - stats.block_cache_hits)
+
+  " Changing lines must not use a remembered block with wrong line numbers.
+  1,20delete
+  call assert_equal('line 4020', getline(4000))
+  call assert_equal('line 30', getline(10))
+  call append(0, 'first')
+  call assert_equal('line 4019', getline(4000))
+  call assert_equal('line 29', getline(10))
+  call setline(4000, 'changed')
+  call assert_equal('changed', getline(4000))
+  call assert_equal('line 29', getline(10))
+  call assert_equal('changed', getline(4000))
+  bwipe!
+endfunc
+
+" Test that the blocks of a hidden buffer are compressed with
+" 'compresshidden' and uncompressed when used again.
+func Test_compresshidden()
+  set compresshidden updatecount=1
+  new Xcompress
+  call setline(1, map(range(1, 20000), '"line " .. v:val .. " of text"'))
+  let bnr = bufnr()
+  hide
+  " Compressing stops when a character is available and continues with the
+  " next sync, every sync compresses at least one block.
+  for i in range(1000)
+    call feedkeys("\<Esc>", 'xt')
+    let stats = memfile_stats(bnr)
+    if stats.compressed_pages == stats.used_pages
+      break
+    endif
+  endfor
+  call assert_true(stats.compressed_pages > 0)
+  call assert_equal(stats.used_pages, stats.compressed_pages)
+
+  call assert_equal(['line 12345 of text'], getbufline(bnr, 12345))
+  call assert_true(memfile_stats(bnr).compressed_pages
+	\ < stats.compressed_pages)
+
+  " the text is written to the swap file uncompressed
+  call setbufline(bnr, 100, 'changed')
+  call feedkeys("\<Esc>", 'xt')
+  exe 'buffer ' .. bnr
+  call assert_equal(20000, line('$'))
+  call assert_equal('changed', getline(100))
+  call assert_equal('line 20000 of text', getline('$'))
+  let content = getline(1, '$')
+  preserve
+  let swapdata = readfile(swapname(''), 'B')
+  set nomodified
+  bwipe!
+  call writefile(swapdata, '.Xcompress.swp')
+  recover Xcompress
+  call assert_equal(content, getline(1, '$'))
+  bwipe!
+  call delete('.Xcompress.swp')
+  set compresshidden& updatecount&
+endfunc
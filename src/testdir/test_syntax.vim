@@ -127,6 +127,49 @@ func Test_syntime_completion()
   call assert_equal('"syntime clear off on report', @:)
 endfunc
 
+func Test_syntime_info()
+  CheckFeature profile
+  new
+  call setline(1, repeat(['x = 1 "a" "b"'], 150)
+        \ + ['( "c"', '', repeat('y', 300), ')'])
+  syn match Number /\d/
+  syn region String start=/"/ end=/"/
+  syn region Paren start=/(/ end=/)/ contains=String
+  setlocal synmaxcol=200
+  syntime clear
+  syntime on
+  redraw
+  normal! G
+  redraw
+  syntime off
+
+  let info = syntime_info()
+  call assert_equal(['depth', 'lines', 'patterns', 'redrawtime', 'synmaxcol'],
+        \ sort(keys(info)))
+  call assert_equal(['Number', 'Paren', 'Paren', 'String', 'String'],
+        \ sort(map(copy(info.patterns), 'v:val.name')))
+  call assert_equal([1, 101], map(copy(info.lines), 'v:val.lnum'))
+  call assert_equal([100, 154], map(copy(info.lines), 'v:val.end'))
+  call assert_equal([0, 1, 2], map(copy(info.depth), 'v:val.depth'))
+  call assert_true(info.lines[0].count > 0)
+  call assert_true(info.lines[0].match > 0)
+  call assert_equal(1, info.synmaxcol)
+  call assert_equal(0, info.redrawtime)
+  call assert_equal(info.patterns[0], json_decode(json_encode(info.patterns[0])))
+
+  let a = execute('syntime report')
+  call assert_match('TOTAL *COUNT *MATCH *SLOWEST *LINES\n.*1-100\n', a)
+  call assert_match('TOTAL *COUNT *MATCH *SLOWEST *DEPTH\n.* 0\n.* 1\n', a)
+  call assert_match("'synmaxcol' reached in 1 lines", a)
+
+  syntime clear
+  let info = syntime_info()
+  call assert_equal([], info.lines)
+  call assert_equal([], info.depth)
+  call assert_equal(0, info.synmaxcol)
+  bwipe!
+endfunc
+
 func Test_syntax_list()
   syntax on
   let a = execute('syntax list')
@@ -471,6 +514,96 @@ func Test_syntax_hangs()
   bwipe!
 endfunc
 
+" Return the number of times syntax patterns were tried for redrawing after
+" executing "cmd".
+func s:SyntaxTries(cmd)
+  syntime clear
+  syntime on
+  exe a:cmd
+  redraw!
+  syntime off
+  let tries = 0
+  for line in split(execute('syntime report'), "\n")[1:]
+    let tries += str2nr(matchstr(line, '^\s*[0-9.]\+\s\+\zs\d\+'))
+  endfor
+  return tries
+endfunc
+
+" Parse the syntax as while waiting for a character, until done.
+func s:ParseWhileIdle()
+  for i in range(1000)
+    if !test_syntax_idle_parse(100)
+      return
+    endif
+  endfor
+  call assert_report('parsing the syntax does not finish')
+endfunc
+
+func Test_syntax_idle_parse()
+  CheckFeature profile
+  new
+  call setline(1, repeat(['/* comment', ' still "comment" */ code "string"'],
+        \ 10000))
+  syn region Comment start="/\*" end="\*/" contains=String
+  syn region String start=+"+ end=+"+
+  syntax sync fromstart
+  redraw
+  let all_tries = s:SyntaxTries('normal! G')
+  call assert_true(all_tries > 20000)
+
+  " while waiting for a character the syntax is parsed in the background
+  syntax sync fromstart
+  normal! gg
+  redraw
+  call s:ParseWhileIdle()
+
+  " jumping to the end then only needs to parse a few lines
+  let tries = s:SyntaxTries('normal! G')
+  call assert_inrange(1, all_tries / 10, tries)
+  call assert_equal('String', synIDattr(synID(line('.'), 26, 1), 'name'))
+
+  " after a change parsing continues from there
+  normal! gg
+  call setline(1, ['/*'])
+  redraw
+  call s:ParseWhileIdle()
+  let tries = s:SyntaxTries('normal! G')
+  call assert_inrange(1, all_tries / 10, tries)
+  bwipe!
+endfunc
+
+func Test_syntax_first_byte()
+  new
+  call setline(1, ['int x = 0x1F;', 'X1 y2 foo', '  #define FOO', 'end', ''])
+  syn case ignore
+  syn match Number /x\d/
+  syn case match
+  syn match Special /\<0x\x\+/
+  syn match PreProc /^\s*\zs#\s*define/
+  syn match Todo /\%(bar\|foo\)$/
+  syn match Error /d\=$/
+  redraw
+  call assert_equal('Special', synIDattr(synID(1, 9, 1), 'name'))
+  call assert_equal('Number', synIDattr(synID(2, 1, 1), 'name'))
+  call assert_equal('', synIDattr(synID(2, 4, 1), 'name'))
+  call assert_equal('Todo', synIDattr(synID(2, 7, 1), 'name'))
+  call assert_equal('PreProc', synIDattr(synID(3, 3, 1), 'name'))
+  call assert_equal('Error', synIDattr(synID(4, 3, 1), 'name'))
+
+  if has('profile')
+    " patterns that can't start with a byte in the line are not tried
+    syntime clear
+    syntime on
+    syn clear
+    syn match Special /\<0x\x\+/
+    call setline(1, repeat(['no numbers here'], 100))
+    redraw!
+    syntime off
+    call assert_notmatch('0x', execute('syntime report'))
+  endif
+  bwipe!
+endfunc
+
 func Test_conceal()
   if !has('conceal')
     return
@@ -131,6 +131,47 @@ func Test_prop_add()
   bwipe!
 endfunc
 
+func Test_prop_add_list()
+  new
+  call AddPropTypes()
+  call setline(1, ['one two three', 'four five', 'six'])
+  let items = [[1, 5, 1, 8], [1, 1, 1, 4], [2, 6, 3, 2], [1, 1, 1, 14]]
+
+  " must give the same result as calling prop_add() for each item
+  for [lnum, col, end_lnum, end_col] in items
+    call prop_add(lnum, col, {'type': 'one', 'id': 5,
+	  \ 'end_lnum': end_lnum, 'end_col': end_col})
+  endfor
+  let expected = [prop_list(1), prop_list(2), prop_list(3)]
+  call prop_clear(1, 3)
+
+  call prop_add_list({'type': 'one', 'id': 5}, items)
+  call assert_equal(expected, [prop_list(1), prop_list(2), prop_list(3)])
+
+  " added to existing properties
+  call prop_clear(1, 3)
+  call prop_add(1, 5, {'type': 'two', 'length': 3})
+  eval {'type': 'three'}->prop_add_list([[1, 1, 1, 4], [1, 9, 1, 14]])
+  call assert_equal(['three', 'two', 'three'],
+	\ map(prop_list(1), {_, v -> v.type}))
+
+  call assert_fails("call prop_add_list({'type': 'one'}, [[1, 1, 1]])", 'E474:')
+  call assert_fails("call prop_add_list({'type': 'one'}, [[4, 1, 4, 1]])", 'E966:')
+  call assert_fails("call prop_add_list({'type': 'one'}, [[1, 1, 4, 1]])", 'E966:')
+  call assert_fails("call prop_add_list({'type': 'one'}, [[1, 0, 1, 1]])", 'E964:')
+  call assert_fails("call prop_add_list({'type': 'one'}, [[3, 9, 3, 10]])", 'E964:')
+  " nothing is added when one of the items is invalid
+  call prop_clear(1, 3)
+  call assert_fails("call prop_add_list({'type': 'one'}, [[1, 1, 1, 2], [3, 9, 3, 10]])", 'E964:')
+  call assert_equal([[], [], []], [prop_list(1), prop_list(2), prop_list(3)])
+  call assert_fails("call prop_add_list({'type': 'one'}, 1)", 'E714:')
+  call assert_fails("call prop_add_list({}, [])", 'E965:')
+  call assert_fails("call prop_add_list({'type': 'one', 'bufnr': 123456}, [])", 'E158:')
+
+  call DeletePropTypes()
+  bwipe!
+endfunc
+
 func Test_prop_remove()
   new
   call AddPropTypes()
@@ -148,6 +189,15 @@ func Test_prop_remove()
   unlet props[1]
   call assert_equal(props, prop_list(1))
 
+  " remove by several types at once
+  call prop_add(1, 1, {'length': 3, 'type': 'one'})
+  call prop_add(1, 2, {'length': 3, 'type': 'one'})
+  call assert_equal(3, prop_remove({'types': ['one', 'three'], 'all': 1}, 1))
+  call assert_equal([props[0]], prop_list(1))
+  call assert_equal(0, prop_remove({'types': ['one']}, 1))
+  call assert_fails("call prop_remove({'types': 'one'}, 1)", 'E714:')
+  call assert_fails("call prop_remove({'types': ['nope']}, 1)", 'E971:')
+
   " remove from unknown buffer
   call assert_fails("call prop_remove({'type': 'one', 'bufnr': 123456}, 1)", 'E158:')
 
@@ -826,6 +876,59 @@ func Test_textprop_remove_from_buf()
   close
 endfunc
 
+" Return the line numbers that have a text property.
+func s:lines_with_props()
+  return filter(range(1, line('$')), {_, l -> !empty(prop_list(l))})
+endfunc
+
+" Return the number of text properties in lines "first" to "last".
+func s:count_props(first, last)
+  let n = 0
+  for lnum in range(a:first, a:last)
+    let n += len(prop_list(lnum))
+  endfor
+  return n
+endfunc
+
+func Test_prop_remove_after_changes()
+  call prop_type_add('one', {})
+  new
+  call setline(1, range(1, 200))
+  for lnum in range(1, 200, 10)
+    call prop_add(lnum, 1, {'type': 'one', 'id': lnum})
+  endfor
+  call prop_add(50, 2, {'type': 'one', 'id': 1, 'end_lnum': 52, 'end_col': 2})
+
+  " the lines with text properties move with the text
+  call append(0, ['a', 'b'])
+  5,8d
+  call append(100, 'c')
+  call setline(51, 'changed')
+  call deletebufline('', 150, 160)
+  let other = bufnr('')
+  hide enew
+  call appendbufline(other, 20, ['x', 'y', 'z'])
+  exe 'buf ' .. other
+  call assert_equal([3, 9, 19, 32, 42, 51, 52, 53, 62, 72, 82, 92, 102, 113,
+	\ 123, 133, 143, 162, 172, 182], s:lines_with_props())
+
+  let cleared = s:count_props(55, 100)
+  call assert_equal(4, cleared)
+  let total = s:count_props(1, line('$'))
+  call prop_clear(55, 100)
+  call assert_equal(0, s:count_props(55, 100))
+  call assert_equal(total - cleared, s:count_props(1, line('$')))
+
+  call assert_equal(1, prop_remove({'id': 1}, 1, 48))
+  call assert_equal(3, prop_remove({'id': 1, 'all': 1}))
+  call assert_equal(total - cleared - 4,
+	\ prop_remove({'type': 'one', 'all': 1}))
+  call assert_equal([], s:lines_with_props())
+
+  bwipe!
+  call prop_type_delete('one')
+endfunc
+
 func Test_textprop_in_unloaded_buf()
   edit Xaaa
   call setline(1, 'aaa')
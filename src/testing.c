@@ -941,5 +941,17 @@ f_test_settime(typval_T *argvars, typval_T *rettv UNUSED)
     time_for_testing = (time_t)tv_get_number(&argvars[0]);
 }
 
+/*
+ * "test_syntax_idle_parse({msec})" function
+ */
+    void
+f_test_syntax_idle_parse(typval_T *argvars UNUSED, typval_T *rettv)
+{
+#ifdef FEAT_SYN_HL
+    syntax_idle_parse((long)tv_get_number(&argvars[0]));
+    rettv->vval.v_number = syntax_idle_pending();
+#endif
+}
+
 
 #endif // defined(FEAT_EVAL)
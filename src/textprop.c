@@ -52,6 +52,22 @@ static char_u e_type_not_exist[] = N_("E971: Property type %s does not exist");
 static char_u e_invalid_col[] = N_("E964: Invalid column number: %ld");
 static char_u e_invalid_lnum[] = N_("E966: Invalid line number: %ld");
 
+// Position of one item passed to prop_add_list().
+typedef struct {
+    linenr_T	pa_start_lnum;
+    colnr_T	pa_start_col;
+    linenr_T	pa_end_lnum;
+    colnr_T	pa_end_col;
+} propadd_T;
+
+// One line of an item passed to prop_add_list(), these are sorted to handle
+// all the properties in a line at once.
+typedef struct {
+    linenr_T	pl_lnum;
+    colnr_T	pl_col;		// start column in this line
+    int		pl_idx;		// index in the list of items
+} propline_T;
+
 /*
  * Find a property type by name, return the hashitem.
  * Returns NULL if the item can't be found.
@@ -150,6 +166,110 @@ get_bufnr_from_arg(typval_T *arg, buf_T **buf)
     return OK;
 }
 
+/*
+ * Fill "tp" with the part in line "lnum" of a property of type "type" that
+ * goes from "start_lnum"/"start_col" to "end_lnum"/"end_col".  "textlen" is
+ * the length of the text of line "lnum", including the NUL.
+ * Returns FAIL when the start column is beyond the end of the line.
+ */
+    static int
+prop_fill_line(
+	textprop_T  *tp,
+	linenr_T    lnum,
+	linenr_T    start_lnum,
+	colnr_T	    start_col,
+	linenr_T    end_lnum,
+	colnr_T	    end_col,
+	size_t	    textlen,
+	int	    id,
+	proptype_T  *type)
+{
+    colnr_T col;	// start column
+    long    length;	// in bytes
+
+    if (lnum == start_lnum)
+	col = start_col;
+    else
+	col = 1;
+    if (col - 1 > (colnr_T)textlen)
+	return FAIL;
+
+    if (lnum == end_lnum)
+	length = end_col - col;
+    else
+	length = (int)textlen - col + 1;
+    if (length > (long)textlen)
+	length = (int)textlen;	// can include the end-of-line
+    if (length < 0)
+	length = 0;		// zero-width property
+
+    tp->tp_col = col;
+    tp->tp_len = length;
+    tp->tp_id = id;
+    tp->tp_type = type->pt_id;
+    tp->tp_flags = (lnum > start_lnum ? TP_FLAG_CONT_PREV : 0)
+			  | (lnum < end_lnum ? TP_FLAG_CONT_NEXT : 0);
+    return OK;
+}
+
+/*
+ * Insert the "count" properties in "new_props", sorted on column, into the
+ * cached line of "buf".  "props" and "proplen" are what get_text_props()
+ * returned for the line, "textlen" is the length of its text.
+ * A new property goes before an existing property with the same column, as
+ * if they were added one by one.
+ * The line is replaced by a new allocation only once, no matter how many
+ * properties are added.
+ */
+    static int
+prop_insert_line(
+	buf_T	    *buf,
+	char_u	    *props,
+	int	    proplen,
+	size_t	    textlen,
+	textprop_T  *new_props,
+	int	    count)
+{
+    char_u	*newtext;
+    char_u	*newprops;
+    textprop_T	tmp_prop;
+    int		i = 0;
+    int		j = 0;
+
+    // Allocate the new line with space for the new properties.
+    newtext = alloc(buf->b_ml.ml_line_len + count * sizeof(textprop_T));
+    if (newtext == NULL)
+	return FAIL;
+    // Copy the text, including terminating NUL.
+    mch_memmove(newtext, buf->b_ml.ml_line_ptr, textlen);
+
+    // Merge the existing and the new properties, both are sorted on column.
+    // Since the text properties are not aligned properly when stored with
+    // the text, we need to copy them as bytes before using it as a struct.
+    newprops = newtext + textlen;
+    while (i < proplen || j < count)
+    {
+	if (i < proplen)
+	    mch_memmove(&tmp_prop, props + i * sizeof(textprop_T),
+							   sizeof(textprop_T));
+	if (j < count && (i == proplen || new_props[j].tp_col <= tmp_prop.tp_col))
+	    mch_memmove(newprops, &new_props[j++], sizeof(textprop_T));
+	else
+	{
+	    mch_memmove(newprops, &tmp_prop, sizeof(textprop_T));
+	    ++i;
+	}
+	newprops += sizeof(textprop_T);
+    }
+
+    if (buf->b_ml.ml_flags & ML_LINE_DIRTY)
+	vim_free(buf->b_ml.ml_line_ptr);
+    buf->b_ml.ml_line_ptr = newtext;
+    buf->b_ml.ml_line_len += count * sizeof(textprop_T);
+    buf->b_ml.ml_flags |= ML_LINE_DIRTY;
+    return OK;
+}
+
 /*
  * prop_add({lnum}, {col}, {props})
  */
@@ -196,13 +316,10 @@ prop_add_common(
     proptype_T	*type;
     buf_T	*buf = default_buf;
     int		id = 0;
-    char_u	*newtext;
     int		proplen;
     size_t	textlen;
     char_u	*props = NULL;
-    char_u	*newprops;
     textprop_T	tmp_prop;
-    int		i;
 
     if (dict == NULL || dict_find(dict, (char_u *)"type", -1) == NULL)
     {
@@ -275,78 +392,217 @@ prop_add_common(
 	return;
     }
 
+    // Set this before changing lines, the memline only keeps track of the
+    // lines with text properties when it is set.
+    buf->b_has_textprop = TRUE;  // this is never reset
+
     for (lnum = start_lnum; lnum <= end_lnum; ++lnum)
     {
-	colnr_T col;	// start column
-	long	length;	// in bytes
-
 	// Fetch the line to get the ml_line_len field updated.
 	proplen = get_text_props(buf, lnum, &props, TRUE);
 	textlen = buf->b_ml.ml_line_len - proplen * sizeof(textprop_T);
 
-	if (lnum == start_lnum)
-	    col = start_col;
-	else
-	    col = 1;
-	if (col - 1 > (colnr_T)textlen)
+	if (prop_fill_line(&tmp_prop, lnum, start_lnum, start_col,
+				     end_lnum, end_col, textlen, id, type) == FAIL)
 	{
 	    semsg(_(e_invalid_col), (long)start_col);
 	    return;
 	}
-
-	if (lnum == end_lnum)
-	    length = end_col - col;
-	else
-	    length = (int)textlen - col + 1;
-	if (length > (long)textlen)
-	    length = (int)textlen;	// can include the end-of-line
-	if (length < 0)
-	    length = 0;		// zero-width property
-
-	// Allocate the new line with space for the new proprety.
-	newtext = alloc(buf->b_ml.ml_line_len + sizeof(textprop_T));
-	if (newtext == NULL)
+	if (prop_insert_line(buf, props, proplen, textlen, &tmp_prop, 1)
+								      == FAIL)
 	    return;
-	// Copy the text, including terminating NUL.
-	mch_memmove(newtext, buf->b_ml.ml_line_ptr, textlen);
+    }
+
+    redraw_buf_later(buf, NOT_VALID);
+}
+
+/*
+ * Compare two propline_T items: on line number, then column, then the later
+ * item first.
+ */
+    static int
+propline_compare(const void *s1, const void *s2)
+{
+    propline_T	*p1 = (propline_T *)s1;
+    propline_T	*p2 = (propline_T *)s2;
+
+    if (p1->pl_lnum != p2->pl_lnum)
+	return p1->pl_lnum < p2->pl_lnum ? -1 : 1;
+    if (p1->pl_col != p2->pl_col)
+	return p1->pl_col < p2->pl_col ? -1 : 1;
+    return p2->pl_idx - p1->pl_idx;
+}
+
+/*
+ * prop_add_list({props}, [[{lnum}, {col}, {end_lnum}, {end_col}], ...])
+ *
+ * Unlike calling prop_add() for each item, every line is changed only once
+ * and the buffer is redrawn once.
+ */
+    void
+f_prop_add_list(typval_T *argvars, typval_T *rettv UNUSED)
+{
+    dict_T	*dict;
+    list_T	*pos_list;
+    listitem_T	*li;
+    char_u	*type_name;
+    proptype_T	*type;
+    buf_T	*buf = curbuf;
+    int		id = 0;
+    propadd_T	*pos = NULL;
+    propline_T	*lines = NULL;
+    textprop_T	*new_props = NULL;
+    int		pos_count;
+    long	line_count = 0;
+    long	i;
+    long	j;
+    int		did_change = FALSE;
 
-	// Find the index where to insert the new property.
-	// Since the text properties are not aligned properly when stored with
-	// the text, we need to copy them as bytes before using it as a struct.
-	for (i = 0; i < proplen; ++i)
+    if (argvars[0].v_type != VAR_DICT || argvars[0].vval.v_dict == NULL)
+    {
+	emsg(_(e_dictreq));
+	return;
+    }
+    if (argvars[1].v_type != VAR_LIST)
+    {
+	emsg(_(e_listreq));
+	return;
+    }
+
+    dict = argvars[0].vval.v_dict;
+    if (dict_find(dict, (char_u *)"type", -1) == NULL)
+    {
+	emsg(_("E965: missing property type name"));
+	return;
+    }
+    type_name = dict_get_string(dict, (char_u *)"type", FALSE);
+    if (dict_find(dict, (char_u *)"id", -1) != NULL)
+	id = dict_get_number(dict, (char_u *)"id");
+
+    if (get_bufnr_from_arg(&argvars[0], &buf) == FAIL)
+	return;
+    type = lookup_prop_type(type_name, buf);
+    if (type == NULL)
+	return;
+    if (buf->b_ml.ml_mfp == NULL)
+    {
+	emsg(_("E275: Cannot add text property to unloaded buffer"));
+	return;
+    }
+
+    pos_list = argvars[1].vval.v_list;
+    pos_count = list_len(pos_list);
+    if (pos_count == 0)
+	return;
+    pos = ALLOC_MULT(propadd_T, pos_count);
+    if (pos == NULL)
+	return;
+
+    // Check all the items before changing anything.
+    i = 0;
+    for (li = pos_list->lv_first; li != NULL; li = li->li_next)
+    {
+	propadd_T   *pa = &pos[i++];
+	list_T	    *l = li->li_tv.vval.v_list;
+
+	if (li->li_tv.v_type != VAR_LIST || l == NULL || list_len(l) != 4)
 	{
-	    mch_memmove(&tmp_prop, props + i * sizeof(textprop_T),
-							   sizeof(textprop_T));
-	    if (tmp_prop.tp_col >= col)
-		break;
+	    emsg(_(e_invarg));
+	    goto theend;
 	}
-	newprops = newtext + textlen;
-	if (i > 0)
-	    mch_memmove(newprops, props, sizeof(textprop_T) * i);
-
-	tmp_prop.tp_col = col;
-	tmp_prop.tp_len = length;
-	tmp_prop.tp_id = id;
-	tmp_prop.tp_type = type->pt_id;
-	tmp_prop.tp_flags = (lnum > start_lnum ? TP_FLAG_CONT_PREV : 0)
-			  | (lnum < end_lnum ? TP_FLAG_CONT_NEXT : 0);
-	mch_memmove(newprops + i * sizeof(textprop_T), &tmp_prop,
-							   sizeof(textprop_T));
+	pa->pa_start_lnum = list_find_nr(l, 0L, NULL);
+	pa->pa_start_col = list_find_nr(l, 1L, NULL);
+	pa->pa_end_lnum = list_find_nr(l, 2L, NULL);
+	pa->pa_end_col = list_find_nr(l, 3L, NULL);
 
-	if (i < proplen)
-	    mch_memmove(newprops + (i + 1) * sizeof(textprop_T),
-					    props + i * sizeof(textprop_T),
-					    sizeof(textprop_T) * (proplen - i));
-
-	if (buf->b_ml.ml_flags & ML_LINE_DIRTY)
-	    vim_free(buf->b_ml.ml_line_ptr);
-	buf->b_ml.ml_line_ptr = newtext;
-	buf->b_ml.ml_line_len += sizeof(textprop_T);
-	buf->b_ml.ml_flags |= ML_LINE_DIRTY;
+	if (pa->pa_start_lnum < 1
+			   || pa->pa_start_lnum > buf->b_ml.ml_line_count)
+	{
+	    semsg(_(e_invalid_lnum), (long)pa->pa_start_lnum);
+	    goto theend;
+	}
+	if (pa->pa_end_lnum < pa->pa_start_lnum
+			     || pa->pa_end_lnum > buf->b_ml.ml_line_count)
+	{
+	    semsg(_(e_invalid_lnum), (long)pa->pa_end_lnum);
+	    goto theend;
+	}
+	// Like prop_fill_line() the property may start just after the
+	// end-of-line.
+	if (pa->pa_start_col < 1 || (size_t)pa->pa_start_col - 1
+		       > STRLEN(ml_get_buf(buf, pa->pa_start_lnum, FALSE)) + 1)
+	{
+	    semsg(_(e_invalid_col), (long)pa->pa_start_col);
+	    goto theend;
+	}
+	if (pa->pa_end_col < 1)
+	{
+	    semsg(_(e_invargval), "end_col");
+	    goto theend;
+	}
+	line_count += pa->pa_end_lnum - pa->pa_start_lnum + 1;
+    }
+
+    // Make a list of the lines of all items, sorted on line and column.
+    lines = ALLOC_MULT(propline_T, line_count);
+    new_props = ALLOC_MULT(textprop_T, pos_count);
+    if (lines == NULL || new_props == NULL)
+	goto theend;
+    j = 0;
+    for (i = 0; i < pos_count; ++i)
+    {
+	linenr_T lnum;
+
+	for (lnum = pos[i].pa_start_lnum; lnum <= pos[i].pa_end_lnum; ++lnum)
+	{
+	    lines[j].pl_lnum = lnum;
+	    lines[j].pl_col = lnum == pos[i].pa_start_lnum
+						   ? pos[i].pa_start_col : 1;
+	    lines[j].pl_idx = i;
+	    ++j;
+	}
     }
+    qsort((void *)lines, (size_t)line_count, sizeof(propline_T),
+							    propline_compare);
 
+    // Set this before changing lines, the memline only keeps track of the
+    // lines with text properties when it is set.
     buf->b_has_textprop = TRUE;  // this is never reset
-    redraw_buf_later(buf, NOT_VALID);
+
+    for (i = 0; i < line_count; i = j)
+    {
+	linenr_T    lnum = lines[i].pl_lnum;
+	char_u	    *props = NULL;
+	int	    proplen;
+	size_t	    textlen;
+	int	    count = 0;
+
+	// Fetch the line to get the ml_line_len field updated.
+	proplen = get_text_props(buf, lnum, &props, TRUE);
+	textlen = buf->b_ml.ml_line_len - proplen * sizeof(textprop_T);
+
+	for (j = i; j < line_count && lines[j].pl_lnum == lnum; ++j)
+	{
+	    propadd_T *pa = &pos[lines[j].pl_idx];
+
+	    // Can't fail, the start column was checked above.
+	    (void)prop_fill_line(&new_props[count++], lnum,
+			    pa->pa_start_lnum, pa->pa_start_col,
+			    pa->pa_end_lnum, pa->pa_end_col,
+			    textlen, id, type);
+	}
+	if (prop_insert_line(buf, props, proplen, textlen, new_props, count)
+								      == FAIL)
+	    goto theend;
+	did_change = TRUE;
+    }
+
+theend:
+    if (did_change)
+	redraw_buf_later(buf, NOT_VALID);
+    vim_free(pos);
+    vim_free(lines);
+    vim_free(new_props);
 }
 
 /*
@@ -397,7 +653,9 @@ find_visible_prop(win_T *wp, int type_id, int id, textprop_T *prop,
 
     // w_botline may not have been updated yet.
     validate_botline();
-    for (lnum = wp->w_topline; lnum < wp->w_botline; ++lnum)
+    for (lnum = ml_next_prop_line(wp->w_buffer, wp->w_topline);
+			       lnum > 0 && lnum < wp->w_botline;
+				 lnum = ml_next_prop_line(wp->w_buffer, lnum + 1))
     {
 	count = get_text_props(wp->w_buffer, lnum, &props, FALSE);
 	for (i = 0; i < count; ++i)
@@ -510,13 +768,13 @@ f_prop_clear(typval_T *argvars, typval_T *rettv UNUSED)
 	return;
     }
 
-    for (lnum = start; lnum <= end; ++lnum)
+    // Only visit the lines that have text properties.
+    for (lnum = ml_next_prop_line(buf, start); lnum > 0 && lnum <= end;
+				       lnum = ml_next_prop_line(buf, lnum + 1))
     {
 	char_u *text;
 	size_t len;
 
-	if (lnum > buf->b_ml.ml_line_count)
-	    break;
 	text = ml_get_buf(buf, lnum, FALSE);
 	len = STRLEN(text) + 1;
 	if ((size_t)buf->b_ml.ml_line_len > len)
@@ -589,6 +847,28 @@ f_prop_list(typval_T *argvars, typval_T *rettv)
     }
 }
 
+/*
+ * Return TRUE if property "tp" is to be removed by prop_remove(): it has id
+ * "id", type "type_id" or one of the "type_count" types in "type_ids".
+ */
+    static int
+prop_remove_match(
+	textprop_T  *tp,
+	int	    id,
+	int	    type_id,
+	int	    *type_ids,
+	int	    type_count)
+{
+    int i;
+
+    if (tp->tp_id == id || tp->tp_type == type_id)
+	return TRUE;
+    for (i = 0; i < type_count; ++i)
+	if (tp->tp_type == type_ids[i])
+	    return TRUE;
+    return FALSE;
+}
+
 /*
  * prop_remove({props} [, {lnum} [, {lnum_end}]])
  */
@@ -604,6 +884,8 @@ f_prop_remove(typval_T *argvars, typval_T *rettv)
     int		do_all = FALSE;
     int		id = -1;
     int		type_id = -1;
+    int		*type_ids = NULL;
+    int		type_count = 0;
 
     rettv->vval.v_number = 0;
     if (argvars[0].v_type != VAR_DICT || argvars[0].vval.v_dict == NULL)
@@ -646,7 +928,37 @@ f_prop_remove(typval_T *argvars, typval_T *rettv)
 	    return;
 	type_id = type->pt_id;
     }
-    if (id == -1 && type_id == -1)
+    if ((di = dict_find(dict, (char_u *)"types", -1)) != NULL)
+    {
+	listitem_T  *li;
+
+	if (di->di_tv.v_type != VAR_LIST)
+	{
+	    emsg(_(e_listreq));
+	    return;
+	}
+	if (di->di_tv.vval.v_list != NULL
+				   && di->di_tv.vval.v_list->lv_len > 0)
+	{
+	    type_ids = ALLOC_MULT(int, di->di_tv.vval.v_list->lv_len);
+	    if (type_ids == NULL)
+		return;
+	    for (li = di->di_tv.vval.v_list->lv_first; li != NULL;
+							     li = li->li_next)
+	    {
+		proptype_T *type = lookup_prop_type(
+					     tv_get_string(&li->li_tv), buf);
+
+		if (type == NULL)
+		{
+		    vim_free(type_ids);
+		    return;
+		}
+		type_ids[type_count++] = type->pt_id;
+	    }
+	}
+    }
+    if (id == -1 && type_id == -1 && type_ids == NULL)
     {
 	emsg(_("E968: Need at least one of 'id' or 'type'"));
 	return;
@@ -654,29 +966,34 @@ f_prop_remove(typval_T *argvars, typval_T *rettv)
 
     if (end == 0)
 	end = buf->b_ml.ml_line_count;
-    for (lnum = start; lnum <= end; ++lnum)
+    // Only visit the lines that have text properties.
+    for (lnum = ml_next_prop_line(buf, start); lnum > 0 && lnum <= end;
+				       lnum = ml_next_prop_line(buf, lnum + 1))
     {
 	char_u *text;
 	size_t len;
 
-	if (lnum > buf->b_ml.ml_line_count)
-	    break;
 	text = ml_get_buf(buf, lnum, FALSE);
 	len = STRLEN(text) + 1;
 	if ((size_t)buf->b_ml.ml_line_len > len)
 	{
 	    static textprop_T textprop;  // static because of alignment
-	    unsigned          idx;
+	    int		      proplen;
+	    int		      idx;
+	    int		      kept = 0;
+	    int		      removed = 0;
+	    char_u	      *props;
 
-	    for (idx = 0; idx < (buf->b_ml.ml_line_len - len)
-						   / sizeof(textprop_T); ++idx)
-	    {
-		char_u *cur_prop = buf->b_ml.ml_line_ptr + len
-						    + idx * sizeof(textprop_T);
-		size_t	taillen;
+	    proplen = (buf->b_ml.ml_line_len - len) / sizeof(textprop_T);
+	    props = buf->b_ml.ml_line_ptr + len;
 
-		mch_memmove(&textprop, cur_prop, sizeof(textprop_T));
-		if (textprop.tp_id == id || textprop.tp_type == type_id)
+	    // Move the properties that are kept to the start, in one pass.
+	    for (idx = 0; idx < proplen; ++idx)
+	    {
+		mch_memmove(&textprop, props + idx * sizeof(textprop_T),
+							   sizeof(textprop_T));
+		if ((do_all || removed == 0) && prop_remove_match(&textprop,
+					     id, type_id, type_ids, type_count))
 		{
 		    if (!(buf->b_ml.ml_flags & ML_LINE_DIRTY))
 		    {
@@ -684,31 +1001,30 @@ f_prop_remove(typval_T *argvars, typval_T *rettv)
 
 			// need to allocate the line to be able to change it
 			if (newptr == NULL)
-			    return;
+			    goto theend;
 			mch_memmove(newptr, buf->b_ml.ml_line_ptr,
 							buf->b_ml.ml_line_len);
 			buf->b_ml.ml_line_ptr = newptr;
 			buf->b_ml.ml_flags |= ML_LINE_DIRTY;
-
-			cur_prop = buf->b_ml.ml_line_ptr + len
-						    + idx * sizeof(textprop_T);
+			props = buf->b_ml.ml_line_ptr + len;
 		    }
-
-		    taillen = buf->b_ml.ml_line_len - len
-					      - (idx + 1) * sizeof(textprop_T);
-		    if (taillen > 0)
-			mch_memmove(cur_prop, cur_prop + sizeof(textprop_T),
-								      taillen);
-		    buf->b_ml.ml_line_len -= sizeof(textprop_T);
-		    --idx;
-
-		    ++rettv->vval.v_number;
-		    if (!do_all)
-			break;
+		    ++removed;
+		}
+		else
+		{
+		    if (kept < idx)
+			mch_memmove(props + kept * sizeof(textprop_T),
+				     &textprop, sizeof(textprop_T));
+		    ++kept;
 		}
 	    }
+	    buf->b_ml.ml_line_len -= removed * sizeof(textprop_T);
+	    rettv->vval.v_number += removed;
 	}
     }
+
+theend:
+    vim_free(type_ids);
     redraw_buf_later(buf, NOT_VALID);
 }
 
@@ -144,6 +144,10 @@ ui_inchar(
 	prof_inchar_enter();
 #endif
 
+    // Show what was drawn so far before waiting.
+    if (wtime != 0)
+	out_flush_collected();
+
 #ifdef NO_CONSOLE_INPUT
     /* Don't wait for character input when the window hasn't been opened yet.
      * Do try reading, this works when redirecting stdin from a file.
@@ -276,6 +280,7 @@ inchar_loop(
     int		did_start_blocking = FALSE;
     long	wait_time;
     long	elapsed_time = 0;
+    int		did_idle = FALSE;
 #ifdef ELAPSED_FUNC
     elapsed_T	start_tv;
 
@@ -376,6 +381,27 @@ inchar_loop(
 	    // for a character, need to check often.
 	    wait_time = 100L;
 #endif
+#ifdef FEAT_SYN_HL
+	// Use the time waiting for a character to parse the syntax further
+	// down in the buffer, a slice at a time.  Check for a character first
+	// and after each slice, so that typing isn't delayed.
+	did_idle = FALSE;
+	if (wait_time != 0 && syntax_idle_pending())
+	{
+	    if (did_call_wait_func)
+	    {
+# ifdef FEAT_TIMERS
+		// Timers that are due must not wait for the parsing.
+		check_due_timer();
+		if (typebuf_changed(tb_change_cnt))
+		    return 0;
+# endif
+		syntax_idle_parse(SYNTAX_IDLE_MSEC);
+	    }
+	    wait_time = 0;
+	    did_idle = TRUE;
+	}
+#endif
 
 	// Wait for a character to be typed or another event, such as the winch
 	// signal or an event on the monitored file descriptors.
@@ -411,6 +437,7 @@ inchar_loop(
 #ifdef MESSAGE_QUEUE
 		|| interrupted
 #endif
+		|| did_idle
 		|| wait_time > 0
 		|| (wtime < 0 && !did_start_blocking))
 	    // no character available, but something to be done, keep going
@@ -532,6 +559,7 @@ ui_char_avail(void)
     void
 ui_delay(long msec, int ignoreinput)
 {
+    out_flush_collected();
 #ifdef FEAT_GUI
     if (gui.in_use && !ignoreinput)
 	gui_wait_for_chars(msec, typebuf.tb_change_cnt);
@@ -848,9 +848,11 @@ extern int (*dyn_libintl_wputenv)(const wchar_t *envstring);
 
 #ifdef FEAT_SYN_HL
 # define SST_MIN_ENTRIES 150	// minimal size for state stack array
-# define SST_MAX_ENTRIES 1000	// maximal size for state stack array
+# define SST_MAX_MEM	 (4L * 1024 * 1024) // max bytes for state stack array
+# define SST_MAX_ENTRIES (SST_MAX_MEM / (long)sizeof(synstate_T))
 # define SST_FIX_STATES	 7	// size of sst_stack[].
 # define SST_DIST	 16	// normal distance between entries
+# define SYNTAX_IDLE_MSEC 10	// msec of parsing while waiting for a char
 # define SST_INVALID	(synstate_T *)-1	// invalid syn_state pointer
 
 # define HL_CONTAINED	0x01	// not used on toplevel
@@ -1764,6 +1766,16 @@ typedef struct timeval proftime_T;
 typedef int proftime_T;	    // dummy for function prototypes
 #endif
 
+// Phases of redrawing that are timed for redraw_stats().
+#define RDT_UPDATE_SCREEN   0	// update_screen()
+#define RDT_WIN_UPDATE	    1	// win_update()
+#define RDT_WIN_LINE	    2	// win_line()
+#define RDT_SYNTAX	    3	// syntax_start() and get_syntax_attr()
+#define RDT_TEXTPROP	    4	// collecting text properties in win_line()
+#define RDT_SCREEN_LINE	    5	// screen_line()
+#define RDT_OUT_FLUSH	    6	// writing output to the terminal
+#define RDT_COUNT	    7
+
 /*
  * When compiling with 32 bit Perl time_t is 32 bits in the Perl code but 64
  * bits elsewhere.  That causes memory corruption.  Define time_T and use it
@@ -4943,6 +4943,9 @@ win_free(
 #ifdef FEAT_SYN_HL
     vim_free(wp->w_p_cc_cols);
 #endif
+#ifdef FEAT_STL_OPT
+    stl_cache_free(wp);
+#endif
 
     if (win_valid_any_tab(wp))
 	win_remove(wp, tp);